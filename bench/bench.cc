@@ -0,0 +1,632 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Benchmark suite for the scratch experiments
+ *
+ * Micro-benchmarks (ReliableHeader serialization) run in this process. The
+ * application benchmarks (EnhancedUdpClient send rate, TcpStatsServer receive
+ * throughput) and the full scenario runs at increasing flow counts run the
+ * experiment binaries as child processes, one process per repetition, and
+ * read the wall-clock time and counters from their result records (see
+ * ../common/simulation-profiler.h), so the ns-3 start-up cost is excluded.
+ * The start-up benchmark measures exactly that cost instead: the CPU time a
+ * one-packet lab3_task1 run spends before its first event. The scheduler
+ * benchmarks repeat a paced client and a 100-flow dumbbell with each event
+ * scheduler (--scheduler, see ../common/scheduler-type.h) and report events
+ * per wall-clock second. The logging benchmarks report events per second of
+ * the per-packet paths with their log components off and on (exp2
+ * --verbose, lab3_task1 through NS_LOG); comparing them between a normal and
+ * a SCRATCH_PERFORMANCE_BUILD build shows what the sampled hot-path logging
+ * (../common/hot-path-log.h) saves.
+ *
+ * Each benchmark is repeated --reps times and reported as median, min, max
+ * and median absolute deviation. The medians are compared with a baseline
+ * file, which is created on the first run and rewritten with
+ * --updateBaseline.
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+
+#include "../common/reliable-header.h"
+#include "../common/result-writer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fcntl.h>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("ScratchBench");
+
+// Set by bench/CMakeLists.txt; override with --exp2Binary/--task1Binary/--comparisonBinary
+#ifndef BENCH_EXP2_BINARY
+#define BENCH_EXP2_BINARY ""
+#endif
+#ifndef BENCH_TASK1_BINARY
+#define BENCH_TASK1_BINARY ""
+#endif
+#ifndef BENCH_COMPARISON_BINARY
+#define BENCH_COMPARISON_BINARY ""
+#endif
+
+struct BenchConfig
+{
+    uint32_t reps = 5;
+    double scale = 1.0;
+    uint32_t maxFlows = 10000;
+    double scenarioTime = 5.0;
+    std::string filter;
+    std::string baseline = "bench-baseline.csv";
+    bool updateBaseline = false;
+    double tolerance = 0.1;
+    bool failOnRegression = false;
+    std::string exp2Binary = BENCH_EXP2_BINARY;
+    std::string task1Binary = BENCH_TASK1_BINARY;
+    std::string comparisonBinary = BENCH_COMPARISON_BINARY;
+    std::string resultFormat = "text";
+    std::string resultFile;
+};
+
+// One benchmark: run() performs one repetition and returns its measurement
+struct Benchmark
+{
+    std::string name;
+    std::string unit;
+    bool higherIsBetter;
+    std::function<double()> run;
+};
+
+// Summary of the repetitions of one benchmark
+struct BenchSummary
+{
+    double median;
+    double min;
+    double max;
+    double mad;
+};
+
+// Baseline median of one benchmark
+struct BaselineEntry
+{
+    std::string unit;
+    double median;
+};
+
+const char* const BASELINE_SCHEMA = "scratch-bench-baseline";
+const uint32_t BASELINE_SCHEMA_VERSION = 1;
+
+double
+Median(std::vector<double> values)
+{
+    std::sort(values.begin(), values.end());
+    size_t n = values.size();
+    return n % 2 == 1 ? values[n / 2] : (values[n / 2 - 1] + values[n / 2]) / 2.0;
+}
+
+BenchSummary
+Summarize(const std::vector<double>& samples)
+{
+    BenchSummary summary;
+    summary.median = Median(samples);
+    summary.min = *std::min_element(samples.begin(), samples.end());
+    summary.max = *std::max_element(samples.begin(), samples.end());
+    std::vector<double> deviations;
+    for (double sample : samples)
+    {
+        deviations.push_back(std::fabs(sample - summary.median));
+    }
+    summary.mad = Median(deviations);
+    return summary;
+}
+
+// Split one CSV line as written by ResultWriter (fields may be quoted)
+std::vector<std::string>
+SplitCsvLine(const std::string& line)
+{
+    std::vector<std::string> fields(1);
+    bool quoted = false;
+    for (size_t i = 0; i < line.size(); ++i)
+    {
+        char c = line[i];
+        if (quoted)
+        {
+            if (c == '"' && i + 1 < line.size() && line[i + 1] == '"')
+            {
+                fields.back() += '"';
+                ++i;
+            }
+            else if (c == '"')
+            {
+                quoted = false;
+            }
+            else
+            {
+                fields.back() += c;
+            }
+        }
+        else if (c == '"')
+        {
+            quoted = true;
+        }
+        else if (c == ',')
+        {
+            fields.emplace_back();
+        }
+        else
+        {
+            fields.back() += c;
+        }
+    }
+    return fields;
+}
+
+// Read a CSV result file as a list of name -> value maps, one per record
+std::vector<std::map<std::string, std::string>>
+ReadCsvRecords(const std::string& filename)
+{
+    std::vector<std::map<std::string, std::string>> records;
+    std::ifstream in(filename);
+    std::string line;
+    if (!std::getline(in, line))
+    {
+        return records;
+    }
+    std::vector<std::string> header = SplitCsvLine(line);
+    while (std::getline(in, line))
+    {
+        std::vector<std::string> values = SplitCsvLine(line);
+        if (values.size() != header.size())
+        {
+            NS_FATAL_ERROR("Malformed result line in " << filename);
+        }
+        std::map<std::string, std::string> record;
+        for (size_t i = 0; i < header.size(); ++i)
+        {
+            record[header[i]] = values[i];
+        }
+        records.push_back(record);
+    }
+    return records;
+}
+
+double
+GetField(const std::map<std::string, std::string>& record, const std::string& name)
+{
+    auto it = record.find(name);
+    if (it == record.end())
+    {
+        NS_FATAL_ERROR("Result record has no field " << name);
+    }
+    return std::stod(it->second);
+}
+
+std::string
+MakeTempFile(const std::string& contents)
+{
+    char path[] = "/tmp/scratch-bench-XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0)
+    {
+        NS_FATAL_ERROR("Cannot create a temporary file");
+    }
+    if (!contents.empty() && write(fd, contents.data(), contents.size()) != (ssize_t)contents.size())
+    {
+        NS_FATAL_ERROR("Cannot write temporary file " << path);
+    }
+    close(fd);
+    return path;
+}
+
+// Run an experiment binary with a csv result file and return its first record.
+// The child's standard output is discarded; its errors stay on stderr unless
+// @p discardLog is set, for runs whose log output (std::clog) would flood it.
+// A non-empty @p nsLog is passed to the child as its NS_LOG variable.
+std::map<std::string, std::string>
+RunExperiment(const std::string& binary,
+              std::vector<std::string> args,
+              bool discardLog = false,
+              const std::string& nsLog = "")
+{
+    if (binary.empty())
+    {
+        NS_FATAL_ERROR("Experiment binary unknown; build through bench/CMakeLists.txt or pass "
+                       "--exp2Binary/--task1Binary/--comparisonBinary");
+    }
+    std::string resultFile = MakeTempFile("");
+    args.insert(args.begin(), binary);
+    args.push_back("--resultFormat=csv");
+    args.push_back("--resultFile=" + resultFile);
+
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        NS_FATAL_ERROR("fork failed");
+    }
+    if (pid == 0)
+    {
+        std::vector<char*> argv;
+        for (std::string& arg : args)
+        {
+            argv.push_back(&arg[0]);
+        }
+        argv.push_back(nullptr);
+        int devNull = open("/dev/null", O_WRONLY);
+        if (devNull >= 0)
+        {
+            dup2(devNull, STDOUT_FILENO);
+            if (discardLog)
+            {
+                dup2(devNull, STDERR_FILENO);
+            }
+        }
+        if (!nsLog.empty())
+        {
+            setenv("NS_LOG", nsLog.c_str(), 1);
+        }
+        execv(binary.c_str(), argv.data());
+        _exit(127);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+    {
+        NS_FATAL_ERROR("Benchmark run of " << binary << " failed");
+    }
+
+    std::vector<std::map<std::string, std::string>> records = ReadCsvRecords(resultFile);
+    std::remove(resultFile.c_str());
+    if (records.empty())
+    {
+        NS_FATAL_ERROR(binary << " wrote no result record");
+    }
+    return records.front();
+}
+
+// Round trip a ReliableHeader through a Packet; returns headers per second
+double
+BenchReliableHeaderPacket(uint64_t iterations)
+{
+    Ptr<Packet> packet = Create<Packet>(1024);
+    ReliableHeader header;
+    ReliableHeader received;
+    uint64_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < iterations; ++i)
+    {
+        header.SetSequenceNumber(static_cast<uint32_t>(i));
+        packet->AddHeader(header);
+        packet->RemoveHeader(received);
+        checksum += received.GetSequenceNumber();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    uint64_t expected = 0;
+    for (uint64_t i = 0; i < iterations; ++i)
+    {
+        expected += static_cast<uint32_t>(i);
+    }
+    if (checksum != expected)
+    {
+        NS_FATAL_ERROR("ReliableHeader round trip corrupted the sequence numbers");
+    }
+    return seconds > 0 ? iterations / seconds : 0.0;
+}
+
+// Serialize and deserialize a ReliableHeader in place; returns headers per second
+double
+BenchReliableHeaderBuffer(uint64_t iterations)
+{
+    ReliableHeader header;
+    ReliableHeader received;
+    Buffer buffer;
+    buffer.AddAtStart(header.GetSerializedSize());
+    uint64_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < iterations; ++i)
+    {
+        header.SetAckNumber(static_cast<uint32_t>(i));
+        header.Serialize(buffer.Begin());
+        received.Deserialize(buffer.Begin());
+        checksum += received.GetAckNumber();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (checksum == 0 && iterations > 1)
+    {
+        NS_FATAL_ERROR("ReliableHeader serialization lost the ack numbers");
+    }
+    return seconds > 0 ? iterations / seconds : 0.0;
+}
+
+std::vector<Benchmark>
+MakeBenchmarks(const BenchConfig& config)
+{
+    std::vector<Benchmark> benchmarks;
+    uint64_t headerIterations = std::max<uint64_t>(1000, static_cast<uint64_t>(1000000 * config.scale));
+    benchmarks.push_back({"reliable-header-packet", "headers/s", true, [headerIterations]() {
+                              return BenchReliableHeaderPacket(headerIterations);
+                          }});
+    benchmarks.push_back({"reliable-header-buffer", "headers/s", true, [headerIterations]() {
+                              return BenchReliableHeaderBuffer(headerIterations);
+                          }});
+
+    // Fixed-rate client on a link that never queues, so every packet is sent
+    // and received; wall-clock packets per second of the whole send path
+    uint32_t packets = std::max<uint32_t>(1000, static_cast<uint32_t>(100000 * config.scale));
+    double sendTime = packets * 1024 * 8.0 / 50e6;
+    std::vector<std::string> clientArgs = {"--policy=Rate",
+                                           "--EnhancedUdpClientRate::DataRate=50Mbps",
+                                           "--dataRate=100Mbps",
+                                           "--packetSize=1024",
+                                           "--maxPackets=" + std::to_string(packets),
+                                           "--simulationTime=" + std::to_string(3.0 + sendTime)};
+    std::string task1Binary = config.task1Binary;
+    benchmarks.push_back({"enhanced-udp-client", "packets/s", true, [task1Binary, clientArgs]() {
+                              auto record = RunExperiment(task1Binary, clientArgs);
+                              return GetField(record, "receivedPackets") / GetField(record, "wallClock");
+                          }});
+
+    // Start-up of a tiny scenario (one packet): CPU seconds the child spends
+    // loading, registering TypeIds and building the scenario before its
+    // first event
+    benchmarks.push_back({"startup", "s", false, [task1Binary]() {
+                              auto record = RunExperiment(task1Binary,
+                                                          {"--maxPackets=1", "--simulationTime=3"});
+                              return GetField(record, "timeToFirstEvent");
+                          }});
+
+    // One TCP flow (next to one UDP flow) on a fast link, application counters
+    // only; simulated TCP bytes delivered to TcpStatsServer per wall-clock second
+    double serverTime = 3.0 + std::max(1.0, 10.0 * config.scale);
+    std::vector<std::string> serverArgs = {"--flowMonitor=false",
+                                           "--simulationTime=" + std::to_string(serverTime)};
+    std::string comparisonBinary = config.comparisonBinary;
+    benchmarks.push_back({"tcp-stats-server", "bytes/s", true, [comparisonBinary, serverArgs]() {
+                              // A one-point matrix instead of the built-in scenarios
+                              std::string matrix = MakeTempFile("dataRate = 1Gbps\n");
+                              std::vector<std::string> args = serverArgs;
+                              args.push_back("--scenarios=" + matrix);
+                              auto record = RunExperiment(comparisonBinary, args);
+                              std::remove(matrix.c_str());
+                              return GetField(record, "tcpBytesReceived") / GetField(record, "wallClock");
+                          }});
+
+    // Full dumbbell scenarios; wall-clock seconds of Simulator::Run()
+    for (uint32_t flows : {2u, 100u, 10000u})
+    {
+        if (flows > config.maxFlows)
+        {
+            continue;
+        }
+        std::string matrix = "topology = dumbbell\nflows = " + std::to_string(flows) +
+                             "\nsimulationTime = " + std::to_string(config.scenarioTime) + "\n";
+        benchmarks.push_back({"scenario-" + std::to_string(flows) + "-flows", "s", false,
+                              [comparisonBinary, matrix]() {
+                                  std::string matrixFile = MakeTempFile(matrix);
+                                  auto record = RunExperiment(comparisonBinary,
+                                                              {"--scenarios=" + matrixFile});
+                                  std::remove(matrixFile.c_str());
+                                  return GetField(record, "wallClock");
+                              }});
+    }
+
+    // The same workloads with each event scheduler. The list scheduler is
+    // left out: it inserts in linear time and would dominate the run time.
+    // The paced client keeps few events pending, the dumbbell many.
+    std::string dumbbellMatrix = "topology = dumbbell\nflows = 100\nsimulationTime = " +
+                                 std::to_string(config.scenarioTime) + "\n";
+    for (const std::string scheduler : {"map", "heap", "calendar", "priority"})
+    {
+        std::vector<std::string> args = clientArgs;
+        args.push_back("--scheduler=" + scheduler);
+        benchmarks.push_back({"scheduler-" + scheduler + "-client", "events/s", true,
+                              [task1Binary, args]() {
+                                  auto record = RunExperiment(task1Binary, args);
+                                  return GetField(record, "eventsPerSecond");
+                              }});
+        if (config.maxFlows < 100)
+        {
+            continue;
+        }
+        benchmarks.push_back({"scheduler-" + scheduler + "-dumbbell", "events/s", true,
+                              [comparisonBinary, dumbbellMatrix, scheduler]() {
+                                  std::string matrixFile = MakeTempFile(dumbbellMatrix);
+                                  auto record = RunExperiment(comparisonBinary,
+                                                              {"--scenarios=" + matrixFile,
+                                                               "--scheduler=" + scheduler});
+                                  std::remove(matrixFile.c_str());
+                                  return GetField(record, "eventsPerSecond");
+                              }});
+    }
+
+    // Per-packet logging off and on. Events per wall-clock second of a
+    // sliding-window transfer (exp2, --verbose) and of the paced client
+    // (lab3_task1, its log component through NS_LOG). The log output is
+    // discarded, so the runs measure formatting, not the terminal. NS_LOG
+    // only has an effect when ns-3 is built with logging (debug or
+    // --enable-logs).
+    uint32_t transferPackets = std::max<uint32_t>(1000, static_cast<uint32_t>(20000 * config.scale));
+    std::vector<std::string> transferArgs = {"--mode=SelectiveRepeat",
+                                             "--windowSize=32",
+                                             "--errorRate=0.01",
+                                             "--interval=0.001",
+                                             "--maxPackets=" + std::to_string(transferPackets),
+                                             "--simulationTime=" +
+                                                 std::to_string(3.0 + transferPackets / 400.0)};
+    std::string exp2Binary = config.exp2Binary;
+    for (bool verbose : {false, true})
+    {
+        std::vector<std::string> args = transferArgs;
+        args.push_back(std::string("--verbose=") + (verbose ? "true" : "false"));
+        benchmarks.push_back({std::string("logging-exp2-") + (verbose ? "verbose" : "quiet"),
+                              "events/s", true, [exp2Binary, args, verbose]() {
+                                  auto record = RunExperiment(exp2Binary, args, verbose);
+                                  return GetField(record, "eventsPerSecond");
+                              }});
+    }
+    for (bool logging : {false, true})
+    {
+        std::string nsLog = logging ? "Lab3Task1=level_info|prefix_time" : "";
+        benchmarks.push_back({std::string("logging-task1-") + (logging ? "info" : "off"),
+                              "events/s", true, [task1Binary, clientArgs, logging, nsLog]() {
+                                  auto record = RunExperiment(task1Binary, clientArgs, logging, nsLog);
+                                  return GetField(record, "eventsPerSecond");
+                              }});
+    }
+    return benchmarks;
+}
+
+std::map<std::string, BaselineEntry>
+LoadBaseline(const std::string& filename)
+{
+    std::map<std::string, BaselineEntry> baseline;
+    std::ifstream probe(filename);
+    if (!probe)
+    {
+        return baseline;
+    }
+    for (const auto& record : ReadCsvRecords(filename))
+    {
+        auto schema = record.find("schema");
+        auto version = record.find("schemaVersion");
+        if (schema == record.end() || schema->second != BASELINE_SCHEMA ||
+            version == record.end() || version->second != std::to_string(BASELINE_SCHEMA_VERSION))
+        {
+            NS_FATAL_ERROR(filename << " is not a " << BASELINE_SCHEMA << " v"
+                                    << BASELINE_SCHEMA_VERSION << " file");
+        }
+        baseline[record.at("name")] = BaselineEntry{record.at("unit"), GetField(record, "median")};
+    }
+    return baseline;
+}
+
+void
+SaveBaseline(const std::string& filename, const std::map<std::string, BaselineEntry>& baseline)
+{
+    ResultWriter writer("csv", BASELINE_SCHEMA, BASELINE_SCHEMA_VERSION, filename);
+    for (const auto& entry : baseline)
+    {
+        ResultRecord record;
+        record.AddString("name", entry.first)
+            .AddString("unit", entry.second.unit)
+            .AddDouble("median", entry.second.median);
+        writer.Write(record);
+    }
+    writer.Flush();
+}
+
+int
+main(int argc, char* argv[])
+{
+    BenchConfig config;
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("reps", "Repetitions of each benchmark", config.reps);
+    cmd.AddValue("scale", "Workload size factor of the micro and application benchmarks", config.scale);
+    cmd.AddValue("maxFlows", "Skip the scenario benchmarks with more flows than this", config.maxFlows);
+    cmd.AddValue("scenarioTime", "Simulation time of the scenario benchmarks in seconds", config.scenarioTime);
+    cmd.AddValue("filter", "Run only the benchmarks whose name contains this string", config.filter);
+    cmd.AddValue("baseline", "Baseline file the medians are compared with (created if missing)", config.baseline);
+    cmd.AddValue("updateBaseline", "Store this run's medians in the baseline file", config.updateBaseline);
+    cmd.AddValue("tolerance", "Relative change of the median reported as a regression or improvement", config.tolerance);
+    cmd.AddValue("failOnRegression", "Exit with status 1 if any benchmark regressed", config.failOnRegression);
+    cmd.AddValue("exp2Binary", "Path of the reliable_transfer_error_model executable", config.exp2Binary);
+    cmd.AddValue("task1Binary", "Path of the lab3_task1 executable", config.task1Binary);
+    cmd.AddValue("comparisonBinary", "Path of the lab3_tcp_udp_comparison executable", config.comparisonBinary);
+    cmd.AddValue("resultFormat", "Result output format (text, csv, jsonl, bin)", config.resultFormat);
+    cmd.AddValue("resultFile", "Result output file for csv/jsonl/bin (default: stdout)", config.resultFile);
+    cmd.Parse(argc, argv);
+
+    if (config.reps == 0)
+    {
+        NS_FATAL_ERROR("reps must be at least 1");
+    }
+
+    std::map<std::string, BaselineEntry> baseline = LoadBaseline(config.baseline);
+    bool writeBaseline = config.updateBaseline || baseline.empty();
+
+    ResultWriter writer(config.resultFormat, "scratch-bench", 1, config.resultFile);
+    bool textOutput = !writer.IsEnabled();
+    if (textOutput)
+    {
+        std::cout << std::left << std::setw(28) << "benchmark" << std::right << std::setw(14)
+                  << "median" << std::setw(14) << "min" << std::setw(14) << "max"
+                  << std::setw(9) << "mad%" << std::setw(10) << "change%"
+                  << "  status" << std::endl;
+    }
+
+    bool regressed = false;
+    for (const Benchmark& benchmark : MakeBenchmarks(config))
+    {
+        if (benchmark.name.find(config.filter) == std::string::npos)
+        {
+            continue;
+        }
+        std::vector<double> samples;
+        for (uint32_t rep = 0; rep < config.reps; ++rep)
+        {
+            samples.push_back(benchmark.run());
+        }
+        BenchSummary summary = Summarize(samples);
+
+        std::string status = "new";
+        double change = 0.0;
+        double baselineMedian = 0.0;
+        auto it = baseline.find(benchmark.name);
+        if (it != baseline.end() && it->second.median > 0)
+        {
+            baselineMedian = it->second.median;
+            change = (summary.median - baselineMedian) / baselineMedian;
+            double gain = benchmark.higherIsBetter ? change : -change;
+            status = gain < -config.tolerance ? "regressed" : gain > config.tolerance ? "improved" : "ok";
+            regressed = regressed || status == "regressed";
+        }
+        if (writeBaseline)
+        {
+            baseline[benchmark.name] = BaselineEntry{benchmark.unit, summary.median};
+        }
+
+        double madPercent = summary.median > 0 ? summary.mad / summary.median * 100.0 : 0.0;
+        ResultRecord record;
+        record.AddString("name", benchmark.name)
+            .AddString("unit", benchmark.unit)
+            .AddUint("reps", config.reps)
+            .AddDouble("median", summary.median)
+            .AddDouble("min", summary.min)
+            .AddDouble("max", summary.max)
+            .AddDouble("mad", summary.mad)
+            .AddDouble("baseline", baselineMedian)
+            .AddDouble("change", change * 100.0)
+            .AddString("status", status);
+        writer.Write(record);
+        writer.Flush();
+        if (textOutput)
+        {
+            std::cout << std::left << std::setw(28) << benchmark.name << std::right
+                      << std::setprecision(4) << std::setw(14) << summary.median << std::setw(14)
+                      << summary.min << std::setw(14) << summary.max << std::fixed
+                      << std::setprecision(1) << std::setw(9) << madPercent << std::setw(10)
+                      << change * 100.0 << std::defaultfloat << "  " << status << " ("
+                      << benchmark.unit << ")" << std::endl;
+        }
+    }
+
+    if (writeBaseline)
+    {
+        SaveBaseline(config.baseline, baseline);
+        if (textOutput)
+        {
+            std::cout << "Baseline written to " << config.baseline << std::endl;
+        }
+    }
+    return config.failOnRegression && regressed ? 1 : 0;
+}
@@ -0,0 +1,57 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "adaptive-sweep.h"
+
+#include "ns3/rng-seed-manager.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+AdaptiveSweep::AdaptiveSweep(const std::vector<std::string>& metrics,
+                             double relativeHalfWidth,
+                             uint32_t minRuns,
+                             uint32_t maxRuns)
+    : m_metrics(metrics),
+      m_relativeHalfWidth(relativeHalfWidth),
+      m_minRuns(std::max(minRuns, 2u)),
+      m_maxRuns(std::max(maxRuns, 1u)),
+      m_converged(false)
+{
+}
+
+ReplicationStats
+AdaptiveSweep::RunPoint(const Replication& replicate)
+{
+    uint64_t baseRun = RngSeedManager::GetRun();
+    ReplicationStats stats;
+    m_converged = false;
+    for (uint32_t i = 0; i < m_maxRuns && !m_converged; ++i)
+    {
+        RngSeedManager::SetRun(baseRun + i);
+        stats.Add(replicate());
+        m_converged = stats.GetCount() >= m_minRuns && stats.IsConverged(m_metrics, m_relativeHalfWidth);
+    }
+    RngSeedManager::SetRun(baseRun);
+    return stats;
+}
+
+bool
+AdaptiveSweep::IsConverged() const
+{
+    return m_converged;
+}
+
+void
+AdaptiveSweep::PrintSummary(std::ostream& os, const ReplicationStats& stats) const
+{
+    os << "\n=== REPLICATION SUMMARY: " << stats.GetCount() << " of at most " << m_maxRuns
+       << " runs (mean +/- 95% CI)" << (m_converged ? ", stopped at the CI target" : "")
+       << " ===" << std::endl;
+    stats.Print(os);
+}
+
+} // namespace ns3
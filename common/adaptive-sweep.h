@@ -0,0 +1,79 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// Adaptive-precision driver for one sweep point.
+//
+// A sweep point (one command line, one batch line) is replicated with
+// consecutive RngRun values until the 95% confidence interval of every
+// target metric is within a relative half-width of its mean, or a maximum
+// number of replications is reached. Cheap, low-variance points therefore
+// stop after MinRuns replications while noisy ones get more, instead of
+// every point paying for a fixed worst-case count.
+
+#ifndef SCRATCH_ADAPTIVE_SWEEP_H
+#define SCRATCH_ADAPTIVE_SWEEP_H
+
+#include "replication-stats.h"
+#include "result-writer.h"
+
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * @brief Replicates one configuration until its confidence intervals converge.
+ */
+class AdaptiveSweep
+{
+  public:
+    /// Runs one replication with the current RngRun and returns its record.
+    using Replication = std::function<ResultRecord()>;
+
+    /**
+     * @param metrics Record fields whose intervals must converge.
+     * @param relativeHalfWidth Target half-width as a fraction of the mean.
+     * @param minRuns Replications to run before stopping early (at least 2).
+     * @param maxRuns Upper bound on the number of replications.
+     */
+    AdaptiveSweep(const std::vector<std::string>& metrics,
+                  double relativeHalfWidth,
+                  uint32_t minRuns,
+                  uint32_t maxRuns);
+
+    /**
+     * Replicate one point with RngRun = current, current + 1, ...; RngRun is
+     * restored afterwards so the next point starts from the same run.
+     *
+     * @param replicate Runs one replication.
+     * @return the statistics over the replications that were run.
+     */
+    ReplicationStats RunPoint(const Replication& replicate);
+
+    /// @return true if the last RunPoint() stopped at the CI target.
+    bool IsConverged() const;
+
+    /**
+     * Print the summary of the last RunPoint().
+     *
+     * @param os Output stream.
+     * @param stats Statistics returned by RunPoint().
+     */
+    void PrintSummary(std::ostream& os, const ReplicationStats& stats) const;
+
+  private:
+    std::vector<std::string> m_metrics;
+    double m_relativeHalfWidth;
+    uint32_t m_minRuns;
+    uint32_t m_maxRuns;
+    bool m_converged;
+};
+
+} // namespace ns3
+
+#endif // SCRATCH_ADAPTIVE_SWEEP_H
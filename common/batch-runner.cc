@@ -0,0 +1,85 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "batch-runner.h"
+
+#include "ns3/config.h"
+#include "ns3/fatal-error.h"
+#include "ns3/log.h"
+
+#include <fstream>
+#include <sstream>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("BatchRunner");
+
+BatchRunner::BatchRunner(int argc, char* argv[], const std::string& batchOption)
+{
+    const std::string prefix = "--" + batchOption;
+    for (int i = 0; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (i > 0 && (arg == prefix || arg.compare(0, prefix.size() + 1, prefix + "=") == 0))
+        {
+            continue;
+        }
+        m_baseArgs.push_back(arg);
+    }
+}
+
+std::vector<std::string>
+BatchRunner::Tokenize(const std::string& line)
+{
+    std::vector<std::string> tokens;
+    std::string content = line.substr(0, line.find('#'));
+    std::istringstream is(content);
+    std::string token;
+    while (is >> token)
+    {
+        if (token.compare(0, 2, "--") != 0)
+        {
+            token = "--" + token;
+        }
+        tokens.push_back(token);
+    }
+    return tokens;
+}
+
+uint32_t
+BatchRunner::Run(const std::string& filename, const RunFunction& run) const
+{
+    std::ifstream in(filename);
+    if (!in)
+    {
+        NS_FATAL_ERROR("Cannot open batch file " << filename);
+    }
+
+    uint32_t count = 0;
+    uint32_t lineNumber = 0;
+    std::string line;
+    while (std::getline(in, line))
+    {
+        ++lineNumber;
+        std::vector<std::string> tokens = Tokenize(line);
+        if (tokens.empty())
+        {
+            continue;
+        }
+
+        std::vector<std::string> args = m_baseArgs;
+        args.insert(args.end(), tokens.begin(), tokens.end());
+        NS_LOG_INFO("Batch line " << lineNumber << ": " << line);
+
+        run(args);
+        ++count;
+
+        // Undo every Config::SetDefault/SetGlobal made by this configuration
+        Config::Reset();
+    }
+    return count;
+}
+
+} // namespace ns3
@@ -0,0 +1,69 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// In-process batch mode for the experiment binaries. A batch file holds one
+// configuration per line, written as command-line options:
+//
+//   # packet size sweep
+//   --packetSize=512  --interval=0.01
+//   packetSize=1024   interval=0.01     # the leading "--" is optional
+//
+// Each line is run in the same process, after the process command line, so a
+// whole sweep pays the ns-3 startup cost (library loading, TypeId registration)
+// once. Between runs every attribute default and global value touched through
+// Config::SetDefault/SetGlobal (including --ns3::... and --RngRun options) is
+// restored with Config::Reset().
+
+#ifndef SCRATCH_BATCH_RUNNER_H
+#define SCRATCH_BATCH_RUNNER_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * @brief Runs one configuration per line of a batch file, in-process.
+ */
+class BatchRunner
+{
+  public:
+    /// Runs one configuration; @p args is a full argv (program name first).
+    using RunFunction = std::function<void(const std::vector<std::string>& args)>;
+
+    /**
+     * @param argc Process argc.
+     * @param argv Process argv. Options named @p batchOption are dropped from
+     *             the base arguments replayed before every line.
+     * @param batchOption Name of the option that selects batch mode.
+     */
+    BatchRunner(int argc, char* argv[], const std::string& batchOption = "batch");
+
+    /**
+     * Read @p filename line by line and call @p run for each configuration.
+     *
+     * @param filename Batch file.
+     * @param run Runs one configuration.
+     * @return the number of configurations run.
+     */
+    uint32_t Run(const std::string& filename, const RunFunction& run) const;
+
+    /**
+     * Split one batch line into options.
+     *
+     * @param line Batch file line.
+     * @return the options, each starting with "--"; empty for blank lines.
+     */
+    static std::vector<std::string> Tokenize(const std::string& line);
+
+  private:
+    std::vector<std::string> m_baseArgs;
+};
+
+} // namespace ns3
+
+#endif // SCRATCH_BATCH_RUNNER_H
@@ -0,0 +1,240 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "binary-tracer.h"
+
+#include "ns3/fatal-error.h"
+#include "ns3/net-device.h"
+#include "ns3/node.h"
+#include "ns3/pointer.h"
+#include "ns3/queue.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace ns3
+{
+
+namespace
+{
+
+const char TRACE_MAGIC[4] = {'N', 'S', '3', 'T'};
+const uint16_t TRACE_FORMAT_VERSION = 1;
+
+} // namespace
+
+BinaryTracer::BinaryTracer(const std::string& filename, uint32_t chunkRecords, uint32_t chunks)
+    : m_file(std::fopen(filename.c_str(), "wb")),
+      m_chunkRecords(std::max(chunkRecords, 1u)),
+      m_chunks(std::max(chunks, 2u), std::vector<BinaryTraceRecord>(m_chunkRecords)),
+      m_current(0),
+      m_fill(0),
+      m_records(0),
+      m_closed(false),
+      m_stopping(false)
+{
+    if (!m_file)
+    {
+        NS_FATAL_ERROR("Cannot open trace file " << filename);
+    }
+    // Chunks are written whole, so stdio buffering would only add a copy
+    std::setvbuf(m_file, nullptr, _IONBF, 0);
+    uint16_t header[2] = {TRACE_FORMAT_VERSION, sizeof(BinaryTraceRecord)};
+    std::fwrite(TRACE_MAGIC, 1, sizeof(TRACE_MAGIC), m_file);
+    std::fwrite(header, sizeof(header), 1, m_file);
+
+    for (uint32_t i = 1; i < m_chunks.size(); ++i)
+    {
+        m_free.push_back(i);
+    }
+    m_writer = std::thread(&BinaryTracer::WriterLoop, this);
+}
+
+BinaryTracer::~BinaryTracer()
+{
+    Close();
+}
+
+void
+BinaryTracer::Install(const NetDeviceContainer& devices)
+{
+    for (auto it = devices.Begin(); it != devices.End(); ++it)
+    {
+        Install(*it);
+    }
+}
+
+void
+BinaryTracer::Install(Ptr<NetDevice> device)
+{
+    m_sources.push_back(Source{this, device->GetNode()->GetId(), device->GetIfIndex()});
+    const Source* source = &m_sources.back();
+
+    PointerValue queue;
+    if (device->GetAttributeFailSafe("TxQueue", queue))
+    {
+        Ptr<Queue<Packet>> txQueue = queue.Get<Queue<Packet>>();
+        if (txQueue)
+        {
+            txQueue->TraceConnectWithoutContext(
+                "Enqueue", MakeBoundCallback(&BinaryTracer::Trace<BinaryTraceRecord::ENQUEUE>, source));
+            txQueue->TraceConnectWithoutContext(
+                "Dequeue", MakeBoundCallback(&BinaryTracer::Trace<BinaryTraceRecord::DEQUEUE>, source));
+            txQueue->TraceConnectWithoutContext(
+                "Drop", MakeBoundCallback(&BinaryTracer::Trace<BinaryTraceRecord::DROP>, source));
+        }
+    }
+    device->TraceConnectWithoutContext(
+        "PhyRxDrop", MakeBoundCallback(&BinaryTracer::Trace<BinaryTraceRecord::RX_DROP>, source));
+    device->TraceConnectWithoutContext(
+        "MacRx", MakeBoundCallback(&BinaryTracer::Trace<BinaryTraceRecord::RX>, source));
+}
+
+template <BinaryTraceRecord::Event EVENT>
+void
+BinaryTracer::Trace(const Source* source, Ptr<const Packet> packet)
+{
+    source->tracer->Record(source->node, source->device, EVENT, packet);
+}
+
+void
+BinaryTracer::Record(uint32_t node,
+                     uint32_t device,
+                     BinaryTraceRecord::Event event,
+                     Ptr<const Packet> packet)
+{
+    if (m_closed)
+    {
+        return;
+    }
+    BinaryTraceRecord& record = m_chunks[m_current][m_fill];
+    record.time = Simulator::Now().GetNanoSeconds();
+    record.node = node;
+    record.device = device;
+    record.event = event;
+    std::memset(record.pad, 0, sizeof(record.pad));
+    record.size = packet->GetSize();
+    record.uid = packet->GetUid();
+    ++m_records;
+    if (++m_fill == m_chunkRecords)
+    {
+        Submit();
+    }
+}
+
+void
+BinaryTracer::Submit()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_full.emplace_back(m_current, m_fill);
+    m_cond.notify_all();
+    m_cond.wait(lock, [this]() { return !m_free.empty(); });
+    m_current = m_free.front();
+    m_free.pop_front();
+    m_fill = 0;
+}
+
+void
+BinaryTracer::WriterLoop()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_cond.wait(lock, [this]() { return m_stopping || !m_full.empty(); });
+        if (m_full.empty())
+        {
+            return;
+        }
+        std::pair<uint32_t, uint32_t> chunk = m_full.front();
+        m_full.pop_front();
+
+        // Write outside the lock so the simulation can keep submitting
+        lock.unlock();
+        if (std::fwrite(m_chunks[chunk.first].data(), sizeof(BinaryTraceRecord), chunk.second, m_file) !=
+            chunk.second)
+        {
+            NS_FATAL_ERROR("Short write to the trace file");
+        }
+        lock.lock();
+
+        m_free.push_back(chunk.first);
+        m_cond.notify_all();
+    }
+}
+
+void
+BinaryTracer::Close()
+{
+    if (m_closed)
+    {
+        return;
+    }
+    m_closed = true;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_fill > 0)
+        {
+            m_full.emplace_back(m_current, m_fill);
+        }
+        m_stopping = true;
+    }
+    m_cond.notify_all();
+    m_writer.join();
+    std::fclose(m_file);
+    m_file = nullptr;
+}
+
+uint64_t
+BinaryTracer::GetRecordCount() const
+{
+    return m_records;
+}
+
+BinaryTraceReader::BinaryTraceReader(const std::string& filename)
+    : m_file(std::fopen(filename.c_str(), "rb")),
+      m_buffer(16384),
+      m_position(0),
+      m_count(0)
+{
+    if (!m_file)
+    {
+        NS_FATAL_ERROR("Cannot open trace file " << filename);
+    }
+    char magic[sizeof(TRACE_MAGIC)];
+    uint16_t header[2];
+    if (std::fread(magic, 1, sizeof(magic), m_file) != sizeof(magic) ||
+        std::memcmp(magic, TRACE_MAGIC, sizeof(magic)) != 0 ||
+        std::fread(header, sizeof(header), 1, m_file) != 1)
+    {
+        NS_FATAL_ERROR(filename << " is not a binary trace file");
+    }
+    if (header[0] != TRACE_FORMAT_VERSION || header[1] != sizeof(BinaryTraceRecord))
+    {
+        NS_FATAL_ERROR(filename << ": unsupported trace format version " << header[0]);
+    }
+}
+
+BinaryTraceReader::~BinaryTraceReader()
+{
+    std::fclose(m_file);
+}
+
+bool
+BinaryTraceReader::Next(BinaryTraceRecord& record)
+{
+    if (m_position == m_count)
+    {
+        m_count = std::fread(m_buffer.data(), sizeof(BinaryTraceRecord), m_buffer.size(), m_file);
+        m_position = 0;
+        if (m_count == 0)
+        {
+            return false;
+        }
+    }
+    record = m_buffer[m_position++];
+    return true;
+}
+
+} // namespace ns3
@@ -0,0 +1,178 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// Compact binary packet tracer, a cheap replacement for ASCII and pcap
+// tracing in long runs.
+//
+// Every traced event appends one fixed-size record to an in-memory chunk; no
+// text is formatted and no packet bytes are copied. Full chunks go to a
+// background thread that writes each one with a single large sequential
+// write, while the simulation fills the next free chunk. The chunks form a
+// ring: the simulation only waits when every chunk is queued for writing.
+//
+// File layout: "NS3T" | u16 format version | u16 record size, then records
+// (host byte order, i.e. little-endian on the supported platforms):
+//
+//   i64 time (ns) | u32 node | u32 device | u8 event | 3 pad | u32 size | u64 uid
+//
+// The events mirror the ones ns-3's ASCII trace writes for a device: queue
+// enqueue (+), dequeue (-) and drop (d), PHY receive drop (d) and MAC
+// receive (r). BinaryTraceReader reads the file back; the exp1
+// binary-trace-convert tool turns it into ASCII or pcap.
+
+#ifndef SCRATCH_BINARY_TRACER_H
+#define SCRATCH_BINARY_TRACER_H
+
+#include "ns3/net-device-container.h"
+#include "ns3/packet.h"
+#include "ns3/ptr.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * @brief One traced event.
+ */
+struct BinaryTraceRecord
+{
+    /// Event types.
+    enum Event : uint8_t
+    {
+        ENQUEUE = 1,
+        DEQUEUE = 2,
+        DROP = 3,
+        RX_DROP = 4,
+        RX = 5
+    };
+
+    int64_t time; // simulation time in nanoseconds
+    uint32_t node;
+    uint32_t device; // interface index on the node
+    uint8_t event;
+    uint8_t pad[3];
+    uint32_t size; // packet size in bytes
+    uint64_t uid;  // packet uid
+};
+
+static_assert(sizeof(BinaryTraceRecord) == 32, "unexpected trace record size");
+
+/**
+ * @brief Records device events into a binary trace file.
+ */
+class BinaryTracer
+{
+  public:
+    /**
+     * @param filename Trace file to create.
+     * @param chunkRecords Records per chunk (one write each).
+     * @param chunks Number of chunks in the ring (at least 2).
+     */
+    BinaryTracer(const std::string& filename,
+                 uint32_t chunkRecords = 16384,
+                 uint32_t chunks = 4);
+
+    /// Flushes and closes the file.
+    ~BinaryTracer();
+
+    BinaryTracer(const BinaryTracer&) = delete;
+    BinaryTracer& operator=(const BinaryTracer&) = delete;
+
+    /**
+     * Trace the queue and receive events of every device.
+     *
+     * @param devices Devices to trace.
+     */
+    void Install(const NetDeviceContainer& devices);
+
+    /// @param device Device to trace.
+    void Install(Ptr<NetDevice> device);
+
+    /**
+     * Append one record.
+     *
+     * @param node Node id.
+     * @param device Interface index.
+     * @param event Event type.
+     * @param packet Traced packet.
+     */
+    void Record(uint32_t node, uint32_t device, BinaryTraceRecord::Event event, Ptr<const Packet> packet);
+
+    /// Write the pending records, stop the writer thread and close the file.
+    /// Events after Close() are ignored.
+    void Close();
+
+    /// @return the number of records traced so far.
+    uint64_t GetRecordCount() const;
+
+  private:
+    /// Where a trace source is attached.
+    struct Source
+    {
+        BinaryTracer* tracer;
+        uint32_t node;
+        uint32_t device;
+    };
+
+    template <BinaryTraceRecord::Event EVENT>
+    static void Trace(const Source* source, Ptr<const Packet> packet);
+
+    void Submit();
+    void WriterLoop();
+
+    std::FILE* m_file;
+    uint32_t m_chunkRecords;
+    std::vector<std::vector<BinaryTraceRecord>> m_chunks;
+    uint32_t m_current; // chunk being filled by the simulation
+    uint32_t m_fill;    // records in the current chunk
+    uint64_t m_records;
+    bool m_closed;
+
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    std::deque<uint32_t> m_free;
+    std::deque<std::pair<uint32_t, uint32_t>> m_full; // chunk, record count
+    bool m_stopping;
+    std::thread m_writer;
+
+    std::deque<Source> m_sources; // stable addresses for the bound callbacks
+};
+
+/**
+ * @brief Sequential reader of a binary trace file.
+ */
+class BinaryTraceReader
+{
+  public:
+    /// @param filename Trace file; aborts if it is missing or malformed.
+    explicit BinaryTraceReader(const std::string& filename);
+    ~BinaryTraceReader();
+
+    BinaryTraceReader(const BinaryTraceReader&) = delete;
+    BinaryTraceReader& operator=(const BinaryTraceReader&) = delete;
+
+    /**
+     * @param record Filled with the next record.
+     * @return false at the end of the file.
+     */
+    bool Next(BinaryTraceRecord& record);
+
+  private:
+    std::FILE* m_file;
+    std::vector<BinaryTraceRecord> m_buffer;
+    size_t m_position;
+    size_t m_count;
+};
+
+} // namespace ns3
+
+#endif // SCRATCH_BINARY_TRACER_H
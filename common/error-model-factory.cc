@@ -0,0 +1,216 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "error-model-factory.h"
+
+#include "gilbert-elliott-error-model.h"
+
+#include "ns3/double.h"
+#include "ns3/fatal-error.h"
+#include "ns3/pointer.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/string.h"
+
+#include <algorithm>
+#include <sstream>
+#include <vector>
+
+namespace ns3
+{
+
+ErrorModelFactory::ErrorModelFactory(const std::string& type,
+                                     double errorRate,
+                                     const std::string& params)
+    : m_type(type),
+      m_errorRate(errorRate)
+{
+    std::vector<std::string> known;
+    if (type == "burst")
+    {
+        known = {"minBurst", "maxBurst"};
+    }
+    else if (type == "gilbert")
+    {
+        known = {"pGoodBad", "pBadGood", "lossGood", "lossBad"};
+    }
+    else if (type != "rate")
+    {
+        NS_FATAL_ERROR("Unknown error model '" << type << "' (expected rate, burst or gilbert)");
+    }
+
+    std::istringstream is(params);
+    std::string item;
+    while (std::getline(is, item, ','))
+    {
+        if (item.empty())
+        {
+            continue;
+        }
+        size_t eq = item.find('=');
+        std::string key = item.substr(0, eq);
+        if (eq == std::string::npos || std::find(known.begin(), known.end(), key) == known.end())
+        {
+            NS_FATAL_ERROR("Invalid parameter '" << item << "' for error model " << type);
+        }
+        std::istringstream value(item.substr(eq + 1));
+        double v;
+        value >> v;
+        if (value.fail() || !value.eof())
+        {
+            NS_FATAL_ERROR("Invalid value in '" << item << "' for error model " << type);
+        }
+        m_params[key] = v;
+    }
+
+    if (type == "burst" && GetParam("minBurst", 1) > GetParam("maxBurst", 4))
+    {
+        NS_FATAL_ERROR("burst error model: minBurst must not exceed maxBurst");
+    }
+    if (type == "gilbert" && m_params.count("pGoodBad") == 0 && m_errorRate > 0.0)
+    {
+        double lossGood = GetParam("lossGood", 0.0);
+        double lossBad = GetParam("lossBad", 1.0);
+        if (m_errorRate <= lossGood || m_errorRate >= lossBad)
+        {
+            NS_FATAL_ERROR("gilbert error model: errorRate must lie between lossGood and lossBad");
+        }
+    }
+}
+
+void
+ErrorModelFactory::Validate(const std::string& type, double errorRate, const std::string& params)
+{
+    // The constructor performs every check
+    ErrorModelFactory check(type, errorRate, params);
+}
+
+double
+ErrorModelFactory::GetParam(const std::string& key, double defaultValue) const
+{
+    auto it = m_params.find(key);
+    return it != m_params.end() ? it->second : defaultValue;
+}
+
+bool
+ErrorModelFactory::IsEnabled() const
+{
+    if (m_type == "gilbert")
+    {
+        return m_errorRate > 0.0 || GetParam("pGoodBad", 0.0) > 0.0 || GetParam("lossGood", 0.0) > 0.0;
+    }
+    return m_errorRate > 0.0;
+}
+
+double
+ErrorModelFactory::GetLossRate() const
+{
+    if (m_type == "burst")
+    {
+        double e = std::min(m_errorRate, 1.0);
+        double burst = (GetParam("minBurst", 1) + GetParam("maxBurst", 4)) / 2;
+        return e > 0.0 ? e * burst / (e * burst + 1 - e) : 0.0;
+    }
+    if (m_type == "gilbert" && m_params.count("pGoodBad") > 0)
+    {
+        double pGoodBad = GetParam("pGoodBad", 0.0);
+        double pBadGood = GetParam("pBadGood", 0.25);
+        if (pGoodBad + pBadGood <= 0.0)
+        {
+            return GetParam("lossGood", 0.0);
+        }
+        return (pGoodBad * GetParam("lossBad", 1.0) + pBadGood * GetParam("lossGood", 0.0)) /
+               (pGoodBad + pBadGood);
+    }
+    if (m_type == "gilbert" && m_errorRate <= 0.0)
+    {
+        return GetParam("lossGood", 0.0);
+    }
+    // rate, and gilbert with pGoodBad derived from errorRate
+    return m_errorRate;
+}
+
+Ptr<ErrorModel>
+ErrorModelFactory::Create() const
+{
+    if (m_type == "burst")
+    {
+        Ptr<UniformRandomVariable> burstSize = CreateObject<UniformRandomVariable>();
+        burstSize->SetAttribute("Min", DoubleValue(GetParam("minBurst", 1)));
+        burstSize->SetAttribute("Max", DoubleValue(GetParam("maxBurst", 4)));
+        Ptr<BurstErrorModel> em = CreateObject<BurstErrorModel>();
+        em->SetAttribute("ErrorRate", DoubleValue(m_errorRate));
+        em->SetAttribute("BurstSize", PointerValue(burstSize));
+        return em;
+    }
+    if (m_type == "gilbert")
+    {
+        double pBadGood = GetParam("pBadGood", 0.25);
+        double lossGood = GetParam("lossGood", 0.0);
+        double lossBad = GetParam("lossBad", 1.0);
+        // Pick the Good -> Bad rate that gives a long-run loss of errorRate
+        double pGoodBad = 0.0;
+        if (m_errorRate > 0.0)
+        {
+            pGoodBad = std::min(1.0, pBadGood * (m_errorRate - lossGood) / (lossBad - m_errorRate));
+        }
+        pGoodBad = GetParam("pGoodBad", pGoodBad);
+        Ptr<GilbertElliottErrorModel> em = CreateObject<GilbertElliottErrorModel>();
+        em->SetAttribute("PGoodBad", DoubleValue(pGoodBad));
+        em->SetAttribute("PBadGood", DoubleValue(pBadGood));
+        em->SetAttribute("LossGood", DoubleValue(lossGood));
+        em->SetAttribute("LossBad", DoubleValue(lossBad));
+        return em;
+    }
+    Ptr<RateErrorModel> em = CreateObject<RateErrorModel>();
+    em->SetAttribute("ErrorRate", DoubleValue(m_errorRate));
+    em->SetAttribute("ErrorUnit", StringValue("ERROR_UNIT_PACKET"));
+    return em;
+}
+
+int64_t
+ErrorModelFactory::AssignStreams(Ptr<ErrorModel> em, int64_t stream)
+{
+    // ErrorModel has no virtual AssignStreams; ask the concrete models
+    if (Ptr<RateErrorModel> rate = DynamicCast<RateErrorModel>(em))
+    {
+        return rate->AssignStreams(stream);
+    }
+    if (Ptr<BurstErrorModel> burst = DynamicCast<BurstErrorModel>(em))
+    {
+        return burst->AssignStreams(stream);
+    }
+    if (Ptr<GilbertElliottErrorModel> gilbert = DynamicCast<GilbertElliottErrorModel>(em))
+    {
+        return gilbert->AssignStreams(stream);
+    }
+    return 0;
+}
+
+int64_t
+ErrorModelFactory::Install(const NetDeviceContainer& devices, bool perDevice, int64_t stream) const
+{
+    int64_t used = 0;
+    Ptr<ErrorModel> em;
+    for (uint32_t i = 0; i < devices.GetN(); ++i)
+    {
+        if (!em || perDevice)
+        {
+            em = Create();
+            if (stream >= 0)
+            {
+                used += AssignStreams(em, stream + used);
+            }
+        }
+        devices.Get(i)->SetAttribute("ReceiveErrorModel", PointerValue(em));
+    }
+    return used;
+}
+
+const std::string&
+ErrorModelFactory::GetType() const
+{
+    return m_type;
+}
+
+} // namespace ns3
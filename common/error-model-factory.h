@@ -0,0 +1,96 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// Builds the packet error models selected on the experiment command lines:
+//
+//   --errorModel=rate     independent losses (RateErrorModel), errorRate = loss rate
+//   --errorModel=burst    BurstErrorModel, errorRate = burst start probability;
+//                         --burstParams=minBurst=1,maxBurst=4 (uniform burst size)
+//   --errorModel=gilbert  GilbertElliottErrorModel; errorRate = long-run loss rate;
+//                         --burstParams=pBadGood=0.25,lossGood=0,lossBad=1
+//                         (pGoodBad is derived from errorRate unless given)
+//
+// Parameters are checked when the factory is built, so a typo fails before
+// any simulation runs.
+
+#ifndef SCRATCH_ERROR_MODEL_FACTORY_H
+#define SCRATCH_ERROR_MODEL_FACTORY_H
+
+#include "ns3/error-model.h"
+#include "ns3/net-device-container.h"
+
+#include <map>
+#include <string>
+
+namespace ns3
+{
+
+/**
+ * @brief Creates and installs packet error models of one configured kind.
+ */
+class ErrorModelFactory
+{
+  public:
+    /**
+     * @param type "rate", "burst" or "gilbert"; aborts on anything else.
+     * @param errorRate Loss rate (rate, gilbert) or burst start rate (burst).
+     * @param params Comma-separated key=value model parameters; aborts on
+     *               keys the model does not know.
+     */
+    ErrorModelFactory(const std::string& type, double errorRate, const std::string& params = "");
+
+    /**
+     * Check a configuration without keeping a factory; aborts like the
+     * constructor on an unknown type, parameter or value.
+     *
+     * @param type Model type, as for the constructor.
+     * @param errorRate Error rate, as for the constructor.
+     * @param params Model parameters, as for the constructor.
+     */
+    static void Validate(const std::string& type, double errorRate, const std::string& params = "");
+
+    /// @return false if the configuration never drops a packet.
+    bool IsEnabled() const;
+
+    /**
+     * @return the long-run fraction of packets a model drops, for analytical
+     *         models of the link (burst: a burst of mean size B starts with
+     *         probability errorRate on a packet outside a burst).
+     */
+    double GetLossRate() const;
+
+    /// @return a new, independent error model.
+    Ptr<ErrorModel> Create() const;
+
+    /**
+     * Set the receive error model of every device in @p devices.
+     *
+     * With @p stream >= 0 the models draw from fixed random streams starting
+     * there, so each device's losses depend only on the run number and its
+     * own traffic, not on how many other random variables were created.
+     *
+     * @param devices Devices with a "ReceiveErrorModel" attribute.
+     * @param perDevice If true each device gets its own model and random
+     *                  stream; otherwise all share one model state.
+     * @param stream First stream index to assign, or -1 to keep the
+     *               automatically assigned streams.
+     * @return the number of stream indices used.
+     */
+    int64_t Install(const NetDeviceContainer& devices, bool perDevice, int64_t stream = -1) const;
+
+    /// @return the model type name.
+    const std::string& GetType() const;
+
+  private:
+    static int64_t AssignStreams(Ptr<ErrorModel> em, int64_t stream);
+    double GetParam(const std::string& key, double defaultValue) const;
+
+    std::string m_type;
+    double m_errorRate;
+    std::map<std::string, double> m_params;
+};
+
+} // namespace ns3
+
+#endif // SCRATCH_ERROR_MODEL_FACTORY_H
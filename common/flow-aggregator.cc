@@ -0,0 +1,152 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "flow-aggregator.h"
+
+#include "flow-tuple-index.h"
+
+#include "ns3/fatal-error.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+namespace
+{
+
+// Marks a FlowId that has not been looked up yet
+const uint32_t UNRESOLVED = FlowAggregator::NO_GROUP - 1;
+
+} // namespace
+
+const uint32_t FlowAggregator::NO_GROUP;
+const uint8_t FlowAggregator::TCP;
+const uint8_t FlowAggregator::UDP;
+
+FlowAggregator::FlowAggregator(Ptr<Ipv4FlowClassifier> classifier)
+    : m_classifier(classifier)
+{
+}
+
+uint32_t
+FlowAggregator::AddGroup(const std::string& name)
+{
+    m_names.push_back(name);
+    m_groups.emplace_back();
+    return m_names.size() - 1;
+}
+
+uint64_t
+FlowAggregator::MakeKey(Ipv4Address address, uint16_t port, uint8_t protocol)
+{
+    return (static_cast<uint64_t>(address.Get()) << 24) | (static_cast<uint64_t>(port) << 8) |
+           protocol;
+}
+
+void
+FlowAggregator::Map(Ipv4Address address, uint16_t port, uint8_t protocol, uint32_t group)
+{
+    if (group >= m_groups.size())
+    {
+        NS_FATAL_ERROR("Unknown flow group " << group);
+    }
+    if (!m_destinations.emplace(MakeKey(address, port, protocol), group).second)
+    {
+        NS_FATAL_ERROR("Destination " << address << ":" << port << " mapped twice");
+    }
+}
+
+uint32_t
+FlowAggregator::GetGroup(FlowId flowId)
+{
+    if (flowId >= m_flowGroups.size() || m_flowGroups[flowId] == UNRESOLVED)
+    {
+        ResolveFlows();
+    }
+    return flowId < m_flowGroups.size() ? m_flowGroups[flowId] : NO_GROUP;
+}
+
+void
+FlowAggregator::ResolveFlows()
+{
+    std::vector<Ipv4FlowClassifier::FiveTuple> tuples;
+    ReadFlowTuples(m_classifier, tuples);
+    if (tuples.size() > m_flowGroups.size())
+    {
+        m_flowGroups.resize(tuples.size(), UNRESOLVED);
+    }
+    for (FlowId flowId = 0; flowId < m_flowGroups.size(); ++flowId)
+    {
+        uint32_t& group = m_flowGroups[flowId];
+        if (group != UNRESOLVED)
+        {
+            continue;
+        }
+        group = NO_GROUP;
+        if (flowId >= tuples.size() || tuples[flowId].protocol == 0)
+        {
+            continue;
+        }
+        const Ipv4FlowClassifier::FiveTuple& t = tuples[flowId];
+        auto it = m_destinations.find(MakeKey(t.destinationAddress, t.destinationPort, t.protocol));
+        if (it == m_destinations.end())
+        {
+            it = m_destinations.find(MakeKey(Ipv4Address::GetAny(), t.destinationPort, t.protocol));
+        }
+        if (it != m_destinations.end())
+        {
+            group = it->second;
+        }
+    }
+}
+
+void
+FlowAggregator::Aggregate(const FlowMonitor::FlowStatsContainer& stats)
+{
+    std::fill(m_groups.begin(), m_groups.end(), GroupStats());
+    for (const auto& flow : stats)
+    {
+        uint32_t group = GetGroup(flow.first);
+        if (group == NO_GROUP)
+        {
+            continue;
+        }
+        const FlowMonitor::FlowStats& s = flow.second;
+        GroupStats& sum = m_groups[group];
+        sum.flows++;
+        sum.txBytes += s.txBytes;
+        sum.rxBytes += s.rxBytes;
+        sum.txPackets += s.txPackets;
+        sum.rxPackets += s.rxPackets;
+        sum.lostPackets += s.lostPackets;
+        sum.delaySum += s.delaySum;
+        sum.jitterSum += s.jitterSum;
+        sum.firstTx = std::min(sum.firstTx, s.timeFirstTxPacket);
+        if (s.rxPackets > 0)
+        {
+            sum.lastRx = std::max(sum.lastRx, s.timeLastRxPacket);
+        }
+    }
+}
+
+uint32_t
+FlowAggregator::GetGroupCount() const
+{
+    return m_groups.size();
+}
+
+const std::string&
+FlowAggregator::GetName(uint32_t group) const
+{
+    return m_names.at(group);
+}
+
+const FlowAggregator::GroupStats&
+FlowAggregator::Get(uint32_t group) const
+{
+    return m_groups.at(group);
+}
+
+} // namespace ns3
@@ -0,0 +1,119 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// Per-group aggregation of FlowMonitor statistics.
+//
+// Groups (one application, one protocol, ...) are declared at install time
+// by their destination address, port and IP protocol. When a FlowId without
+// a group shows up, the five-tuples of all flows classified so far are read
+// in one pass (flow-tuple-index.h) and each new flow's group is cached in a
+// vector indexed by FlowId, so an Aggregate() that meets F new flows costs
+// O(F) and later lookups are O(1). Aggregate() sums (never overwrites) the
+// stats of all flows of a group in a single pass over the flow table.
+
+#ifndef SCRATCH_FLOW_AGGREGATOR_H
+#define SCRATCH_FLOW_AGGREGATOR_H
+
+#include "ns3/flow-monitor.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/ipv4-flow-classifier.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * @brief Sums FlowMonitor stats over groups of flows keyed by destination.
+ */
+class FlowAggregator
+{
+  public:
+    /// Group of flows that match no registered destination.
+    static const uint32_t NO_GROUP = std::numeric_limits<uint32_t>::max();
+
+    /// IP protocol numbers used as group keys.
+    static const uint8_t TCP = 6;
+    static const uint8_t UDP = 17;
+
+    /// Sums over the flows of one group.
+    struct GroupStats
+    {
+        uint32_t flows = 0;
+        uint64_t txBytes = 0;
+        uint64_t rxBytes = 0;
+        uint64_t txPackets = 0;
+        uint64_t rxPackets = 0;
+        uint64_t lostPackets = 0;
+        Time delaySum;
+        Time jitterSum;
+        Time firstTx = Time::Max();
+        Time lastRx = Time::Min();
+    };
+
+    /// @param classifier Classifier of the monitor whose stats are aggregated.
+    explicit FlowAggregator(Ptr<Ipv4FlowClassifier> classifier);
+
+    /**
+     * Declare a group.
+     *
+     * @param name Group name, for reports.
+     * @return the group index (groups are numbered from 0 in order).
+     */
+    uint32_t AddGroup(const std::string& name);
+
+    /**
+     * Assign every flow towards a destination to @p group.
+     *
+     * @param address Destination address; Ipv4Address::GetAny() matches any.
+     * @param port Destination port.
+     * @param protocol IP protocol (TCP or UDP).
+     * @param group Group returned by AddGroup().
+     */
+    void Map(Ipv4Address address, uint16_t port, uint8_t protocol, uint32_t group);
+
+    /**
+     * Reset the group sums and accumulate @p stats into them.
+     *
+     * @param stats Flow table of the monitor.
+     */
+    void Aggregate(const FlowMonitor::FlowStatsContainer& stats);
+
+    /**
+     * @param flowId Flow of the classifier.
+     * @return the group of the flow, NO_GROUP if it matches none.
+     */
+    uint32_t GetGroup(FlowId flowId);
+
+    /// @return the number of groups.
+    uint32_t GetGroupCount() const;
+
+    /// @return the name of @p group.
+    const std::string& GetName(uint32_t group) const;
+
+    /// @return the sums of @p group from the last Aggregate().
+    const GroupStats& Get(uint32_t group) const;
+
+  private:
+    static uint64_t MakeKey(Ipv4Address address, uint16_t port, uint8_t protocol);
+
+    /// Resolve the group of every flow the classifier has seen so far.
+    void ResolveFlows();
+
+    Ptr<Ipv4FlowClassifier> m_classifier;
+    std::vector<std::string> m_names;
+    std::vector<GroupStats> m_groups;
+    std::unordered_map<uint64_t, uint32_t> m_destinations;
+    std::vector<uint32_t> m_flowGroups; // indexed by FlowId
+};
+
+} // namespace ns3
+
+#endif // SCRATCH_FLOW_AGGREGATOR_H
@@ -0,0 +1,138 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "flow-stats-sampler.h"
+
+#include "flow-tuple-index.h"
+
+#include "ns3/fatal-error.h"
+#include "ns3/simulator.h"
+
+namespace ns3
+{
+
+FlowStatsSampler::FlowStatsSampler(Ptr<FlowMonitor> monitor,
+                                   Ptr<Ipv4FlowClassifier> classifier,
+                                   const std::string& format,
+                                   const std::string& filename,
+                                   Time interval)
+    : m_monitor(monitor),
+      m_classifier(classifier),
+      m_writer(format, "flow-samples", SCHEMA_VERSION, filename),
+      m_interval(interval),
+      m_records(0)
+{
+    if (!m_writer.IsEnabled())
+    {
+        NS_FATAL_ERROR("Flow samples need a structured format (csv, jsonl or bin)");
+    }
+    if (!interval.IsStrictlyPositive())
+    {
+        NS_FATAL_ERROR("Flow sample interval must be positive");
+    }
+}
+
+FlowStatsSampler::~FlowStatsSampler()
+{
+    Simulator::Cancel(m_event);
+    m_writer.Flush();
+}
+
+void
+FlowStatsSampler::Start(Time start)
+{
+    m_lastSample = start;
+    m_event = Simulator::Schedule(start + m_interval - Simulator::Now(), &FlowStatsSampler::Sample, this);
+}
+
+void
+FlowStatsSampler::Sample()
+{
+    WriteDeltas();
+    m_event = Simulator::Schedule(m_interval, &FlowStatsSampler::Sample, this);
+}
+
+void
+FlowStatsSampler::Flush()
+{
+    if (Simulator::Now() > m_lastSample)
+    {
+        WriteDeltas();
+    }
+    m_writer.Flush();
+}
+
+void
+FlowStatsSampler::WriteDeltas()
+{
+    Time now = Simulator::Now();
+    double elapsed = (now - m_lastSample).GetSeconds();
+    m_lastSample = now;
+
+    m_monitor->CheckForLostPackets();
+    const FlowMonitor::FlowStatsContainer& flows = m_monitor->GetFlowStats();
+    // Classify the flows that showed up since the last sample in one pass
+    std::vector<Ipv4FlowClassifier::FiveTuple> tuples;
+    for (const auto& flow : flows)
+    {
+        if (flow.first >= m_flows.size() || !m_flows[flow.first].known)
+        {
+            ReadFlowTuples(m_classifier, tuples);
+            break;
+        }
+    }
+    for (const auto& flow : flows)
+    {
+        const FlowMonitor::FlowStats& stats = flow.second;
+        if (flow.first >= m_flows.size())
+        {
+            m_flows.resize(flow.first + 1);
+        }
+        FlowState& last = m_flows[flow.first];
+        if (!last.known && flow.first < tuples.size())
+        {
+            last.known = true;
+            last.protocol = tuples[flow.first].protocol;
+            last.dstPort = tuples[flow.first].destinationPort;
+        }
+        if (stats.txPackets == last.txPackets && stats.rxPackets == last.rxPackets &&
+            stats.lostPackets == last.lostPackets)
+        {
+            continue;
+        }
+
+        uint64_t rxBytes = stats.rxBytes - last.rxBytes;
+        ResultRecord record;
+        record.AddDouble("time", now.GetSeconds())
+            .AddUint("flowId", flow.first)
+            .AddUint("protocol", last.protocol)
+            .AddUint("dstPort", last.dstPort)
+            .AddUint("txBytes", stats.txBytes - last.txBytes)
+            .AddUint("rxBytes", rxBytes)
+            .AddUint("txPackets", stats.txPackets - last.txPackets)
+            .AddUint("rxPackets", stats.rxPackets - last.rxPackets)
+            .AddUint("lostPackets", stats.lostPackets - last.lostPackets)
+            .AddDouble("delaySum", (stats.delaySum - last.delaySum).GetSeconds())
+            .AddDouble("jitterSum", (stats.jitterSum - last.jitterSum).GetSeconds())
+            .AddDouble("throughput", elapsed > 0 ? rxBytes * 8.0 / elapsed / 1000000.0 : 0.0);
+        m_writer.Write(record);
+        ++m_records;
+
+        last.txBytes = stats.txBytes;
+        last.rxBytes = stats.rxBytes;
+        last.txPackets = stats.txPackets;
+        last.rxPackets = stats.rxPackets;
+        last.lostPackets = stats.lostPackets;
+        last.delaySum = stats.delaySum;
+        last.jitterSum = stats.jitterSum;
+    }
+}
+
+uint64_t
+FlowStatsSampler::GetRecordsWritten() const
+{
+    return m_records;
+}
+
+} // namespace ns3
@@ -0,0 +1,73 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "flow-tuple-index.h"
+
+#include "ns3/fatal-error.h"
+
+#include <cstdlib>
+#include <sstream>
+#include <string>
+
+namespace ns3
+{
+
+namespace
+{
+
+/// Value of attribute @p name in the element starting at @p element.
+std::string
+GetAttribute(const std::string& xml, std::string::size_type element, const char* name)
+{
+    std::string key = std::string(" ") + name + "=\"";
+    std::string::size_type end = xml.find('>', element);
+    std::string::size_type begin = xml.find(key, element);
+    if (begin == std::string::npos || begin > end)
+    {
+        NS_FATAL_ERROR("Flow classifier element without attribute " << name);
+    }
+    begin += key.size();
+    return xml.substr(begin, xml.find('"', begin) - begin);
+}
+
+uint32_t
+GetUintAttribute(const std::string& xml, std::string::size_type element, const char* name)
+{
+    return std::strtoul(GetAttribute(xml, element, name).c_str(), nullptr, 10);
+}
+
+} // namespace
+
+void
+ReadFlowTuples(Ptr<Ipv4FlowClassifier> classifier,
+               std::vector<Ipv4FlowClassifier::FiveTuple>& tuples)
+{
+    std::ostringstream os;
+    classifier->SerializeToXmlStream(os, 0);
+    const std::string xml = os.str();
+
+    Ipv4FlowClassifier::FiveTuple none;
+    none.protocol = 0;
+    none.sourcePort = 0;
+    none.destinationPort = 0;
+    for (std::string::size_type element = xml.find("<Flow ");
+         element != std::string::npos;
+         element = xml.find("<Flow ", element + 1))
+    {
+        FlowId flowId = GetUintAttribute(xml, element, "flowId");
+        if (flowId >= tuples.size())
+        {
+            tuples.resize(flowId + 1, none);
+        }
+        Ipv4FlowClassifier::FiveTuple& t = tuples[flowId];
+        t.sourceAddress = Ipv4Address(GetAttribute(xml, element, "sourceAddress").c_str());
+        t.destinationAddress =
+            Ipv4Address(GetAttribute(xml, element, "destinationAddress").c_str());
+        t.protocol = GetUintAttribute(xml, element, "protocol");
+        t.sourcePort = GetUintAttribute(xml, element, "sourcePort");
+        t.destinationPort = GetUintAttribute(xml, element, "destinationPort");
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,36 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// Five-tuples of all flows of an Ipv4FlowClassifier, read in one pass.
+//
+// Ipv4FlowClassifier::FindFlow() scans the classifier's whole flow map for
+// each lookup, so resolving F flows one at a time costs O(F^2). The
+// classifier has no public iterator, but SerializeToXmlStream() walks the
+// same map once; ReadFlowTuples() parses its <Flow> elements into a vector
+// indexed by FlowId, which resolves every flow seen so far in O(F).
+
+#ifndef SCRATCH_FLOW_TUPLE_INDEX_H
+#define SCRATCH_FLOW_TUPLE_INDEX_H
+
+#include "ns3/ipv4-flow-classifier.h"
+#include "ns3/ptr.h"
+
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * Read the five-tuples of every flow @p classifier has classified so far.
+ *
+ * @param classifier Classifier to read.
+ * @param[out] tuples Five-tuples indexed by FlowId; ids the classifier has
+ *                    not assigned have protocol 0.
+ */
+void ReadFlowTuples(Ptr<Ipv4FlowClassifier> classifier,
+                    std::vector<Ipv4FlowClassifier::FiveTuple>& tuples);
+
+} // namespace ns3
+
+#endif // SCRATCH_FLOW_TUPLE_INDEX_H
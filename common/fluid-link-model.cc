@@ -0,0 +1,233 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "fluid-link-model.h"
+
+#include "ns3/fatal-error.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace ns3
+{
+
+namespace
+{
+
+// Rounds of the RTT fixed point (a backlogged TCP flow's RTT grows by the
+// queueing delay, which lowers its demand)
+const uint32_t FIXED_POINT_ROUNDS = 20;
+
+// Bisection steps when inverting the TCP response function
+const uint32_t BISECTION_STEPS = 100;
+
+const double MIN_LOSS_RATE = 1e-12;
+
+} // namespace
+
+FluidLinkModel::FluidLinkModel(const Link& link, const Tcp& tcp)
+    : m_link(link),
+      m_tcp(tcp)
+{
+    if (m_link.capacity <= 0 || m_link.baseRtt <= 0)
+    {
+        NS_FATAL_ERROR("Fluid model needs a positive link capacity and RTT");
+    }
+}
+
+uint32_t
+FluidLinkModel::AddTcpFlow()
+{
+    m_flows.push_back(Flow{true, 0.0, FlowState()});
+    return m_flows.size() - 1;
+}
+
+uint32_t
+FluidLinkModel::AddCbrFlow(double rate)
+{
+    m_flows.push_back(Flow{false, rate, FlowState()});
+    return m_flows.size() - 1;
+}
+
+const FluidLinkModel::FlowState&
+FluidLinkModel::GetFlow(uint32_t flow) const
+{
+    return m_flows.at(flow).state;
+}
+
+FluidLinkModel::TcpVariant
+FluidLinkModel::ParseTcpVariant(const std::string& name)
+{
+    if (name == "NewReno")
+    {
+        return NEW_RENO;
+    }
+    else if (name == "Cubic")
+    {
+        return CUBIC;
+    }
+    else if (name == "Vegas")
+    {
+        return VEGAS;
+    }
+    NS_FATAL_ERROR("No fluid model for TCP " << name << " (expected NewReno, Cubic or Vegas)");
+    return NEW_RENO;
+}
+
+double
+FluidLinkModel::GetTcpSegmentRate(double lossRate, double rtt) const
+{
+    if (lossRate <= 0)
+    {
+        return std::numeric_limits<double>::infinity();
+    }
+    // Padhye, Firoiu, Towsley and Kurose, with b segments per ACK
+    double p = std::min(lossRate, 1.0);
+    double b = std::max<uint32_t>(m_tcp.delAckCount, 1);
+    double reno = 1.0 / (rtt * std::sqrt(2 * b * p / 3) +
+                         m_tcp.minRto * std::min(1.0, 3 * std::sqrt(3 * b * p / 8)) * p *
+                             (1 + 32 * p * p));
+    if (m_tcp.variant != CUBIC)
+    {
+        return reno;
+    }
+    // RFC 8312 average window; Cubic never does worse than its Reno-friendly region
+    double cubicWindow = std::pow(m_tcp.cubicC * (3 + m_tcp.cubicBeta) / (4 * (1 - m_tcp.cubicBeta)),
+                                  0.25) *
+                         std::pow(rtt, 0.75) / std::pow(p, 0.75);
+    return std::max(reno, cubicWindow / rtt);
+}
+
+double
+FluidLinkModel::GetTcpDemand(double rtt) const
+{
+    double segmentBits = (m_tcp.segmentSize + m_tcp.headerBytes) * 8.0;
+    double windowRate = m_tcp.maxWindow / m_tcp.segmentSize / rtt;
+    return std::min(windowRate, GetTcpSegmentRate(m_link.lossRate, rtt)) * segmentBits;
+}
+
+double
+FluidLinkModel::GetTcpLossAt(double segmentRate, double rtt) const
+{
+    double low = std::max(m_link.lossRate, MIN_LOSS_RATE);
+    if (GetTcpSegmentRate(low, rtt) <= segmentRate)
+    {
+        return m_link.lossRate;
+    }
+    double high = 1.0;
+    if (GetTcpSegmentRate(high, rtt) >= segmentRate)
+    {
+        return high;
+    }
+    // The response function falls monotonically with the loss rate
+    for (uint32_t i = 0; i < BISECTION_STEPS; ++i)
+    {
+        double mid = std::sqrt(low * high);
+        if (GetTcpSegmentRate(mid, rtt) > segmentRate)
+        {
+            low = mid;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    return std::sqrt(low * high);
+}
+
+void
+FluidLinkModel::ShareCapacity(const std::vector<double>& demands, std::vector<double>& shares) const
+{
+    std::vector<size_t> order(demands.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&demands](size_t a, size_t b) {
+        return demands[a] < demands[b];
+    });
+    shares.assign(demands.size(), 0.0);
+    double remaining = m_link.capacity;
+    for (size_t k = 0; k < order.size(); ++k)
+    {
+        double fairShare = remaining / (order.size() - k);
+        double share = std::min(demands[order[k]], fairShare);
+        shares[order[k]] = share;
+        remaining -= share;
+    }
+}
+
+void
+FluidLinkModel::Solve()
+{
+    size_t n = m_flows.size();
+    double segmentBits = (m_tcp.segmentSize + m_tcp.headerBytes) * 8.0;
+    std::vector<double> rtt(n, m_link.baseRtt);
+    std::vector<double> demands(n);
+    std::vector<double> shares(n);
+    std::vector<bool> backlogged(n, false);
+
+    for (uint32_t round = 0; round < FIXED_POINT_ROUNDS; ++round)
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            demands[i] = m_flows[i].tcp ? GetTcpDemand(rtt[i]) : m_flows[i].offered;
+        }
+        ShareCapacity(demands, shares);
+
+        // Queueing delay only grows, so the fixed point settles
+        bool changed = false;
+        for (size_t i = 0; i < n; ++i)
+        {
+            Flow& flow = m_flows[i];
+            backlogged[i] = shares[i] < demands[i] * (1 - 1e-9);
+            double queueDelay = 0.0;
+            if (backlogged[i])
+            {
+                queueDelay = m_link.aqmTarget;
+                if (flow.tcp && m_tcp.variant == VEGAS && shares[i] > 0)
+                {
+                    double vegasQueue = (m_tcp.vegasAlpha + m_tcp.vegasBeta) / 2 * segmentBits;
+                    queueDelay = std::min(queueDelay, vegasQueue / shares[i]);
+                }
+            }
+            queueDelay = std::max(queueDelay, flow.state.queueDelay);
+            if (flow.tcp && queueDelay > flow.state.queueDelay)
+            {
+                changed = true;
+            }
+            flow.state.queueDelay = queueDelay;
+            if (flow.tcp)
+            {
+                rtt[i] = m_link.baseRtt + queueDelay;
+            }
+        }
+        if (!changed)
+        {
+            break;
+        }
+    }
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        FlowState& state = m_flows[i].state;
+        if (m_flows[i].tcp)
+        {
+            state.lossRate =
+                backlogged[i] ? GetTcpLossAt(shares[i] / segmentBits, rtt[i]) : m_link.lossRate;
+            // The AQM drops part of what arrives, the random loss part of what it serves
+            double queuePass = (1 - state.lossRate) / (1 - m_link.lossRate);
+            state.sendRate = queuePass > 0 ? shares[i] / queuePass : shares[i];
+            state.deliveredRate = shares[i] * (1 - m_link.lossRate);
+        }
+        else
+        {
+            state.sendRate = m_flows[i].offered;
+            state.deliveredRate = shares[i] * (1 - m_link.lossRate);
+            state.lossRate =
+                state.sendRate > 0 ? 1 - state.deliveredRate / state.sendRate : 0.0;
+        }
+    }
+}
+
+} // namespace ns3
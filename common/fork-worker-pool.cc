@@ -0,0 +1,221 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "fork-worker-pool.h"
+
+#include "ns3/fatal-error.h"
+#include "ns3/log.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("ForkWorkerPool");
+
+namespace
+{
+
+/// One running child and the bytes it has sent so far.
+struct Worker
+{
+    pid_t pid;
+    int fd;
+    uint64_t index;
+    std::string buffer;
+};
+
+bool
+WriteAll(int fd, const char* data, size_t size)
+{
+    while (size > 0)
+    {
+        ssize_t n = write(fd, data, size);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+} // namespace
+
+ForkWorkerPool::ForkWorkerPool(uint32_t workers)
+    : m_workers(workers),
+      m_isolated(false)
+{
+    if (m_workers == 0)
+    {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        m_workers = cpus > 0 ? static_cast<uint32_t>(cpus) : 1;
+    }
+}
+
+void
+ForkWorkerPool::SetIsolated(bool isolated)
+{
+    m_isolated = isolated;
+}
+
+uint32_t
+ForkWorkerPool::GetWorkers() const
+{
+    return m_workers;
+}
+
+void
+ForkWorkerPool::Run(uint64_t nTasks, Task task, Sink sink)
+{
+    if (!m_isolated && (m_workers <= 1 || nTasks <= 1))
+    {
+        RunSerial(nTasks, task, sink);
+    }
+    else
+    {
+        RunForked(nTasks, task, sink);
+    }
+}
+
+void
+ForkWorkerPool::RunSerial(uint64_t nTasks, Task& task, Sink& sink)
+{
+    for (uint64_t i = 0; i < nTasks; ++i)
+    {
+        sink(i, task(i));
+    }
+}
+
+void
+ForkWorkerPool::RunForked(uint64_t nTasks, Task& task, Sink& sink)
+{
+    // Results that finished ahead of the next index to emit. Dispatch is
+    // limited to a window past that index so this stays O(workers).
+    std::map<uint64_t, std::string> finished;
+    std::vector<Worker> running;
+    const uint64_t window = 4 * static_cast<uint64_t>(m_workers);
+    uint64_t nextDispatch = 0;
+    uint64_t nextEmit = 0;
+
+    while (nextEmit < nTasks)
+    {
+        while (running.size() < m_workers && nextDispatch < nTasks &&
+               nextDispatch < nextEmit + window)
+        {
+            int fds[2];
+            if (pipe(fds) != 0)
+            {
+                NS_FATAL_ERROR("pipe() failed: " << std::strerror(errno));
+            }
+
+            // The child inherits unflushed stdio buffers; flush them first so
+            // nothing is printed twice.
+            std::cout.flush();
+            std::fflush(nullptr);
+
+            pid_t pid = fork();
+            if (pid < 0)
+            {
+                NS_FATAL_ERROR("fork() failed: " << std::strerror(errno));
+            }
+            if (pid == 0)
+            {
+                close(fds[0]);
+                for (const Worker& w : running)
+                {
+                    close(w.fd);
+                }
+                std::string payload = task(nextDispatch);
+                uint64_t size = payload.size();
+                bool ok = WriteAll(fds[1], reinterpret_cast<const char*>(&size), sizeof(size)) &&
+                          WriteAll(fds[1], payload.data(), payload.size());
+                close(fds[1]);
+                _exit(ok ? 0 : 1);
+            }
+
+            close(fds[1]);
+            NS_LOG_INFO("Task " << nextDispatch << " started in pid " << pid);
+            running.push_back(Worker{pid, fds[0], nextDispatch, std::string()});
+            ++nextDispatch;
+        }
+
+        std::vector<pollfd> pfds;
+        pfds.reserve(running.size());
+        for (const Worker& w : running)
+        {
+            pfds.push_back(pollfd{w.fd, POLLIN, 0});
+        }
+        if (poll(pfds.data(), pfds.size(), -1) < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            NS_FATAL_ERROR("poll() failed: " << std::strerror(errno));
+        }
+
+        for (size_t i = pfds.size(); i-- > 0;)
+        {
+            if (pfds[i].revents == 0)
+            {
+                continue;
+            }
+            Worker& w = running[i];
+            char chunk[65536];
+            ssize_t n = read(w.fd, chunk, sizeof(chunk));
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (n > 0)
+            {
+                w.buffer.append(chunk, static_cast<size_t>(n));
+                continue;
+            }
+
+            // EOF (or read error): reap the child and validate the payload.
+            close(w.fd);
+            int status = 0;
+            while (waitpid(w.pid, &status, 0) < 0 && errno == EINTR)
+            {
+            }
+            uint64_t size = 0;
+            if (!WIFEXITED(status) || WEXITSTATUS(status) != 0 || w.buffer.size() < sizeof(size))
+            {
+                NS_FATAL_ERROR("Worker for task " << w.index << " (pid " << w.pid
+                                                  << ") failed, status " << status);
+            }
+            std::memcpy(&size, w.buffer.data(), sizeof(size));
+            if (w.buffer.size() != sizeof(size) + size)
+            {
+                NS_FATAL_ERROR("Worker for task " << w.index << " sent a truncated result");
+            }
+            finished.emplace(w.index, w.buffer.substr(sizeof(size)));
+            running.erase(running.begin() + i);
+        }
+
+        for (auto it = finished.find(nextEmit); it != finished.end(); it = finished.find(nextEmit))
+        {
+            sink(it->first, it->second);
+            finished.erase(it);
+            ++nextEmit;
+        }
+    }
+}
+
+} // namespace ns3
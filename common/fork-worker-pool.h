@@ -0,0 +1,75 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// Runs independent simulation tasks in forked worker processes. Each task
+// executes in its own child (so Simulator::Run/Destroy never interfere), sends
+// an opaque serialized result back over a pipe, and the parent hands results to
+// the sink strictly in task order. Because every child starts as a copy of
+// the parent, tasks can also resume a simulation the parent has run up to a
+// checkpoint (see SetIsolated()).
+
+#ifndef SCRATCH_FORK_WORKER_POOL_H
+#define SCRATCH_FORK_WORKER_POOL_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace ns3
+{
+
+/**
+ * @brief Fixed-size pool of forked worker processes.
+ *
+ * With a single worker the tasks run in-process, one after another, which
+ * keeps the historical behaviour (and debuggability) of the experiments.
+ */
+class ForkWorkerPool
+{
+  public:
+    /// Computes the serialized result of task @p index (runs in the child).
+    using Task = std::function<std::string(uint64_t index)>;
+    /// Consumes the result of task @p index (runs in the parent, in order).
+    using Sink = std::function<void(uint64_t index, const std::string& payload)>;
+
+    /**
+     * @param workers Maximum number of concurrent children; 0 selects the
+     *                number of online CPUs.
+     */
+    explicit ForkWorkerPool(uint32_t workers);
+
+    /**
+     * Fork a child for every task even with a single worker or task.
+     *
+     * Needed when tasks modify in-memory state that each of them must see
+     * as it was when Run() was called, e.g. a simulation paused at a
+     * checkpoint.
+     *
+     * @param isolated Whether tasks never run in-process.
+     */
+    void SetIsolated(bool isolated);
+
+    /**
+     * Run tasks [0, nTasks) and deliver their results in index order.
+     *
+     * @param nTasks Number of tasks.
+     * @param task Task body.
+     * @param sink Result consumer.
+     */
+    void Run(uint64_t nTasks, Task task, Sink sink);
+
+    /// @return the effective number of workers.
+    uint32_t GetWorkers() const;
+
+  private:
+    void RunSerial(uint64_t nTasks, Task& task, Sink& sink);
+    void RunForked(uint64_t nTasks, Task& task, Sink& sink);
+
+    uint32_t m_workers;
+    bool m_isolated;
+};
+
+} // namespace ns3
+
+#endif // SCRATCH_FORK_WORKER_POOL_H
@@ -0,0 +1,95 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "gilbert-elliott-error-model.h"
+
+#include "ns3/double.h"
+#include "ns3/pointer.h"
+#include "ns3/string.h"
+
+namespace ns3
+{
+
+NS_OBJECT_ENSURE_REGISTERED(GilbertElliottErrorModel);
+
+TypeId
+GilbertElliottErrorModel::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("GilbertElliottErrorModel")
+            .SetParent<ErrorModel>()
+            .SetGroupName("Network")
+            .AddConstructor<GilbertElliottErrorModel>()
+            .AddAttribute("PGoodBad",
+                          "Probability of moving from the Good to the Bad state after a packet",
+                          DoubleValue(0.0),
+                          MakeDoubleAccessor(&GilbertElliottErrorModel::m_pGoodBad),
+                          MakeDoubleChecker<double>(0.0, 1.0))
+            .AddAttribute("PBadGood",
+                          "Probability of moving from the Bad to the Good state after a packet",
+                          DoubleValue(0.25),
+                          MakeDoubleAccessor(&GilbertElliottErrorModel::m_pBadGood),
+                          MakeDoubleChecker<double>(0.0, 1.0))
+            .AddAttribute("LossGood",
+                          "Packet loss probability in the Good state",
+                          DoubleValue(0.0),
+                          MakeDoubleAccessor(&GilbertElliottErrorModel::m_lossGood),
+                          MakeDoubleChecker<double>(0.0, 1.0))
+            .AddAttribute("LossBad",
+                          "Packet loss probability in the Bad state",
+                          DoubleValue(1.0),
+                          MakeDoubleAccessor(&GilbertElliottErrorModel::m_lossBad),
+                          MakeDoubleChecker<double>(0.0, 1.0))
+            .AddAttribute("RanVar",
+                          "The decision variable attached to this error model",
+                          StringValue("ns3::UniformRandomVariable[Min=0.0|Max=1.0]"),
+                          MakePointerAccessor(&GilbertElliottErrorModel::m_ranvar),
+                          MakePointerChecker<RandomVariableStream>());
+    return tid;
+}
+
+GilbertElliottErrorModel::GilbertElliottErrorModel()
+    : m_pGoodBad(0.0),
+      m_pBadGood(0.25),
+      m_lossGood(0.0),
+      m_lossBad(1.0),
+      m_bad(false)
+{
+}
+
+int64_t
+GilbertElliottErrorModel::AssignStreams(int64_t stream)
+{
+    m_ranvar->SetStream(stream);
+    return 1;
+}
+
+bool
+GilbertElliottErrorModel::IsBad() const
+{
+    return m_bad;
+}
+
+bool
+GilbertElliottErrorModel::DoCorrupt(Ptr<Packet> p)
+{
+    // Loss in the current state; probabilities of 0 and 1 need no draw
+    double loss = m_bad ? m_lossBad : m_lossGood;
+    bool corrupt = loss >= 1.0 || (loss > 0.0 && m_ranvar->GetValue() < loss);
+
+    double leave = m_bad ? m_pBadGood : m_pGoodBad;
+    if (leave > 0.0 && m_ranvar->GetValue() < leave)
+    {
+        m_bad = !m_bad;
+    }
+    return corrupt;
+}
+
+void
+GilbertElliottErrorModel::DoReset()
+{
+    m_bad = false;
+}
+
+} // namespace ns3
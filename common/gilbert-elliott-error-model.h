@@ -0,0 +1,66 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// Two-state Markov (Gilbert-Elliott) packet error model.
+//
+// The channel is either Good or Bad. Each packet is lost with the loss
+// probability of the current state, then the state moves Good -> Bad with
+// probability PGoodBad and Bad -> Good with probability PBadGood. Losses thus
+// come in bursts of mean length about 1 / PBadGood packets (with LossBad = 1),
+// and the long-run loss rate is
+//
+//   (PGoodBad * LossBad + PBadGood * LossGood) / (PGoodBad + PBadGood).
+//
+// Each packet costs at most two uniform draws and no allocation.
+
+#ifndef SCRATCH_GILBERT_ELLIOTT_ERROR_MODEL_H
+#define SCRATCH_GILBERT_ELLIOTT_ERROR_MODEL_H
+
+#include "ns3/error-model.h"
+#include "ns3/random-variable-stream.h"
+
+namespace ns3
+{
+
+/**
+ * @brief Bursty packet loss driven by a two-state Markov chain.
+ */
+class GilbertElliottErrorModel : public ErrorModel
+{
+  public:
+    /**
+     * @brief Get the type ID.
+     * @return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    GilbertElliottErrorModel();
+
+    /**
+     * Assign a fixed random variable stream number to the random variables
+     * used by this model.
+     *
+     * @param stream First stream index to use.
+     * @return the number of stream indices assigned by this model.
+     */
+    int64_t AssignStreams(int64_t stream);
+
+    /// @return true while the channel is in the Bad state.
+    bool IsBad() const;
+
+  private:
+    bool DoCorrupt(Ptr<Packet> p) override;
+    void DoReset() override;
+
+    double m_pGoodBad;
+    double m_pBadGood;
+    double m_lossGood;
+    double m_lossBad;
+    bool m_bad;
+    Ptr<RandomVariableStream> m_ranvar;
+};
+
+} // namespace ns3
+
+#endif // SCRATCH_GILBERT_ELLIOTT_ERROR_MODEL_H
@@ -0,0 +1,49 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// Logging for per-packet hot paths.
+//
+// HOT_PATH_LOG_INFO(msg) and HOT_PATH_LOG_DEBUG(msg) mark an NS_LOG_INFO or
+// NS_LOG_DEBUG that would otherwise run (and, with the component enabled,
+// format its operands) on every packet. In a normal build they are exactly
+// those macros. In a performance build (CMake
+// option SCRATCH_PERFORMANCE_BUILD, which defines the macro of the same
+// name) each call site only counts its calls and logs the first one and then
+// every SCRATCH_HOT_PATH_LOG_EVERY-th, tagged with the count; the other calls
+// cost one increment and never touch the log machinery.
+//
+// Rare events (timeouts, retransmissions, out-of-order arrivals) should keep
+// using NS_LOG_INFO so they are always reported in full.
+
+#ifndef SCRATCH_HOT_PATH_LOG_H
+#define SCRATCH_HOT_PATH_LOG_H
+
+#include "ns3/log.h"
+
+#include <cstdint>
+
+#ifndef SCRATCH_HOT_PATH_LOG_EVERY
+#define SCRATCH_HOT_PATH_LOG_EVERY 1000
+#endif
+
+#ifdef SCRATCH_PERFORMANCE_BUILD
+#define HOT_PATH_LOG(level, msg)                                                                   \
+    do                                                                                             \
+    {                                                                                              \
+        static uint64_t hotPathLogCount = 0;                                                       \
+        if (hotPathLogCount++ % SCRATCH_HOT_PATH_LOG_EVERY == 0)                                   \
+        {                                                                                          \
+            NS_LOG(level,                                                                          \
+                   msg << " [call " << hotPathLogCount << ", logging 1 in "                        \
+                       << SCRATCH_HOT_PATH_LOG_EVERY << "]");                                      \
+        }                                                                                          \
+    } while (false)
+#else
+#define HOT_PATH_LOG(level, msg) NS_LOG(level, msg)
+#endif
+
+#define HOT_PATH_LOG_INFO(msg) HOT_PATH_LOG(ns3::LOG_INFO, msg)
+#define HOT_PATH_LOG_DEBUG(msg) HOT_PATH_LOG(ns3::LOG_DEBUG, msg)
+
+#endif // SCRATCH_HOT_PATH_LOG_H
@@ -0,0 +1,258 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "latency-histogram.h"
+
+#include "ns3/fatal-error.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace ns3
+{
+
+namespace
+{
+
+const uint32_t SUB_BUCKET_BITS = 8;
+const uint32_t SUB_BUCKET_COUNT = 1u << SUB_BUCKET_BITS;
+const uint32_t SUB_BUCKET_HALF = SUB_BUCKET_COUNT / 2;
+const uint32_t MAX_VALUE_BITS = 42;
+const uint64_t MAX_VALUE = (uint64_t(1) << MAX_VALUE_BITS) - 1;
+const uint32_t BUCKET_COUNT = SUB_BUCKET_COUNT + (MAX_VALUE_BITS - SUB_BUCKET_BITS) * SUB_BUCKET_HALF;
+
+uint32_t
+MostSignificantBit(uint64_t value)
+{
+    return 63 - __builtin_clzll(value);
+}
+
+template <typename T>
+void
+Append(std::string& out, T value)
+{
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+T
+Extract(const std::string& data, size_t& offset)
+{
+    T value;
+    if (data.size() - offset < sizeof(value))
+    {
+        NS_FATAL_ERROR("Corrupted latency histogram");
+    }
+    std::memcpy(&value, data.data() + offset, sizeof(value));
+    offset += sizeof(value);
+    return value;
+}
+
+} // namespace
+
+LatencyHistogram::LatencyHistogram()
+    : m_buckets(BUCKET_COUNT, 0),
+      m_count(0),
+      m_sum(0.0)
+{
+}
+
+uint32_t
+LatencyHistogram::GetIndex(uint64_t value)
+{
+    if (value > MAX_VALUE)
+    {
+        value = MAX_VALUE;
+    }
+    if (value < SUB_BUCKET_COUNT)
+    {
+        return static_cast<uint32_t>(value);
+    }
+    // Keep the top SUB_BUCKET_BITS bits; the sub-bucket is in [HALF, COUNT)
+    uint32_t shift = MostSignificantBit(value) - (SUB_BUCKET_BITS - 1);
+    return SUB_BUCKET_COUNT + (shift - 1) * SUB_BUCKET_HALF +
+           static_cast<uint32_t>((value >> shift) - SUB_BUCKET_HALF);
+}
+
+uint64_t
+LatencyHistogram::GetLowestValue(uint32_t index)
+{
+    if (index < SUB_BUCKET_COUNT)
+    {
+        return index;
+    }
+    uint32_t k = index - SUB_BUCKET_COUNT;
+    uint32_t shift = k / SUB_BUCKET_HALF + 1;
+    return static_cast<uint64_t>(k % SUB_BUCKET_HALF + SUB_BUCKET_HALF) << shift;
+}
+
+uint64_t
+LatencyHistogram::GetHighestValue(uint32_t index)
+{
+    if (index < SUB_BUCKET_COUNT)
+    {
+        return index;
+    }
+    uint32_t shift = (index - SUB_BUCKET_COUNT) / SUB_BUCKET_HALF + 1;
+    return GetLowestValue(index) + (uint64_t(1) << shift) - 1;
+}
+
+void
+LatencyHistogram::Record(uint64_t valueNs, uint64_t count)
+{
+    m_buckets[GetIndex(valueNs)] += count;
+    m_count += count;
+    m_sum += static_cast<double>(valueNs) * count;
+}
+
+void
+LatencyHistogram::Merge(const LatencyHistogram& other)
+{
+    for (uint32_t i = 0; i < BUCKET_COUNT; ++i)
+    {
+        m_buckets[i] += other.m_buckets[i];
+    }
+    m_count += other.m_count;
+    m_sum += other.m_sum;
+}
+
+void
+LatencyHistogram::Reset()
+{
+    std::fill(m_buckets.begin(), m_buckets.end(), 0);
+    m_count = 0;
+    m_sum = 0.0;
+}
+
+uint64_t
+LatencyHistogram::GetCount() const
+{
+    return m_count;
+}
+
+double
+LatencyHistogram::GetMean() const
+{
+    return m_count > 0 ? m_sum / m_count : 0.0;
+}
+
+uint64_t
+LatencyHistogram::GetMin() const
+{
+    for (uint32_t i = 0; i < BUCKET_COUNT; ++i)
+    {
+        if (m_buckets[i] > 0)
+        {
+            return GetLowestValue(i);
+        }
+    }
+    return 0;
+}
+
+uint64_t
+LatencyHistogram::GetMax() const
+{
+    for (uint32_t i = BUCKET_COUNT; i-- > 0;)
+    {
+        if (m_buckets[i] > 0)
+        {
+            return GetHighestValue(i);
+        }
+    }
+    return 0;
+}
+
+uint64_t
+LatencyHistogram::GetValueAtQuantile(double quantile) const
+{
+    if (m_count == 0)
+    {
+        return 0;
+    }
+    quantile = std::min(std::max(quantile, 0.0), 1.0);
+    uint64_t target = static_cast<uint64_t>(quantile * m_count + 0.5);
+    target = std::max<uint64_t>(target, 1);
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < BUCKET_COUNT; ++i)
+    {
+        seen += m_buckets[i];
+        if (seen >= target)
+        {
+            return GetHighestValue(i);
+        }
+    }
+    return GetMax();
+}
+
+std::string
+LatencyHistogram::Serialize() const
+{
+    std::string out;
+    Append<uint64_t>(out, m_count);
+    Append<double>(out, m_sum);
+    uint32_t used = 0;
+    for (uint64_t c : m_buckets)
+    {
+        used += c > 0 ? 1 : 0;
+    }
+    Append<uint32_t>(out, used);
+    for (uint32_t i = 0; i < BUCKET_COUNT; ++i)
+    {
+        if (m_buckets[i] > 0)
+        {
+            Append<uint32_t>(out, i);
+            Append<uint64_t>(out, m_buckets[i]);
+        }
+    }
+    return out;
+}
+
+void
+LatencyHistogram::Deserialize(const std::string& data)
+{
+    Reset();
+    size_t offset = 0;
+    m_count = Extract<uint64_t>(data, offset);
+    m_sum = Extract<double>(data, offset);
+    uint32_t used = Extract<uint32_t>(data, offset);
+    for (uint32_t n = 0; n < used; ++n)
+    {
+        uint32_t i = Extract<uint32_t>(data, offset);
+        if (i >= BUCKET_COUNT)
+        {
+            NS_FATAL_ERROR("Corrupted latency histogram");
+        }
+        m_buckets[i] = Extract<uint64_t>(data, offset);
+    }
+}
+
+const std::vector<uint64_t>&
+LatencyHistogram::GetBuckets() const
+{
+    return m_buckets;
+}
+
+double
+LatencyHistogram::GetSum() const
+{
+    return m_sum;
+}
+
+void
+LatencyHistogram::SetBuckets(const std::vector<uint64_t>& buckets, double sum)
+{
+    if (buckets.size() != BUCKET_COUNT)
+    {
+        NS_FATAL_ERROR("Latency histogram bucket count mismatch");
+    }
+    m_buckets = buckets;
+    m_count = 0;
+    for (uint64_t c : m_buckets)
+    {
+        m_count += c;
+    }
+    m_sum = sum;
+}
+
+} // namespace ns3
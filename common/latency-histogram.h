@@ -0,0 +1,101 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// Fixed-memory streaming latency histogram in the style of HdrHistogram.
+//
+// Values (nanoseconds) are counted in log-linear buckets: exact below 256, and
+// above that each power of two is split into 128 sub-buckets, so every
+// recorded value is known to within 1/128 (< 0.8%) of its true value. Values up
+// to 2^42 ns (about 73 minutes) are tracked; larger values count in the last
+// bucket. The bucket array is allocated once (36 KiB) and never grows, so
+// recording is O(1) and quantiles are O(buckets).
+
+#ifndef SCRATCH_LATENCY_HISTOGRAM_H
+#define SCRATCH_LATENCY_HISTOGRAM_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * @brief Log-linear histogram of latencies in nanoseconds.
+ */
+class LatencyHistogram
+{
+  public:
+    LatencyHistogram();
+
+    /**
+     * Record @p count occurrences of a value.
+     *
+     * @param valueNs Latency in nanoseconds.
+     * @param count Number of occurrences.
+     */
+    void Record(uint64_t valueNs, uint64_t count = 1);
+
+    /// Add all the counts of @p other to this histogram.
+    void Merge(const LatencyHistogram& other);
+
+    /// Remove every recorded value.
+    void Reset();
+
+    /// @return the number of recorded values.
+    uint64_t GetCount() const;
+
+    /// @return the mean of the recorded values in nanoseconds, 0 if empty.
+    double GetMean() const;
+
+    /// @return the smallest recorded value (bucket resolution), 0 if empty.
+    uint64_t GetMin() const;
+
+    /// @return the largest recorded value (bucket resolution), 0 if empty.
+    uint64_t GetMax() const;
+
+    /**
+     * @param quantile Quantile in [0, 1], e.g. 0.99.
+     * @return the highest value equivalent to the bucket holding the
+     *         quantile, so the result never understates the tail; 0 if empty.
+     */
+    uint64_t GetValueAtQuantile(double quantile) const;
+
+    /// @return the histogram as a compact byte string (non-empty buckets only).
+    std::string Serialize() const;
+
+    /**
+     * Replace the contents with a histogram produced by Serialize().
+     *
+     * @param data Serialized histogram; aborts if it is malformed.
+     */
+    void Deserialize(const std::string& data);
+
+    /// @return the raw bucket counts, for summing histograms across processes.
+    const std::vector<uint64_t>& GetBuckets() const;
+
+    /// @return the sum of all recorded values in nanoseconds.
+    double GetSum() const;
+
+    /**
+     * Replace the contents with summed bucket counts (see GetBuckets()).
+     *
+     * @param buckets Bucket counts; must have GetBuckets().size() entries.
+     * @param sum Sum of the recorded values in nanoseconds.
+     */
+    void SetBuckets(const std::vector<uint64_t>& buckets, double sum);
+
+  private:
+    static uint32_t GetIndex(uint64_t value);
+    static uint64_t GetLowestValue(uint32_t index);
+    static uint64_t GetHighestValue(uint32_t index);
+
+    std::vector<uint64_t> m_buckets;
+    uint64_t m_count;
+    double m_sum;
+};
+
+} // namespace ns3
+
+#endif // SCRATCH_LATENCY_HISTOGRAM_H
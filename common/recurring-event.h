@@ -0,0 +1,116 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// Recycled events for timers an application schedules over and over.
+//
+// Simulator::Schedule(delay, &T::Method, this) allocates a new EventImpl for
+// every call, and a paced sender or a retransmission timer makes that call
+// once per packet. RecurringEvent keeps the EventImpl objects of one
+// member-function event on a free list: an event goes back on the list when
+// it fires, so the usual "fire, then schedule the next one" pattern reuses
+// the same object forever. A cancelled event is never recycled (ns-3 cannot
+// un-cancel an EventImpl); the simulator releases it as usual.
+//
+// The returned EventId behaves like the one from Simulator::Schedule: it can
+// be cancelled, and it expires when the event fires, even though the object
+// behind it lives on.
+
+#ifndef SCRATCH_RECURRING_EVENT_H
+#define SCRATCH_RECURRING_EVENT_H
+
+#include "ns3/event-id.h"
+#include "ns3/event-impl.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+#include "ns3/simulator.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * @brief A member-function event of one object, scheduled with recycled EventImpl objects.
+ *
+ * @tparam T The object's class.
+ */
+template <typename T>
+class RecurringEvent
+{
+  public:
+    /// The method called when an event fires.
+    using Method = void (T::*)();
+
+    /**
+     * @param object Object the method is called on; must outlive every pending event.
+     * @param method Method to call.
+     */
+    RecurringEvent(T* object, Method method)
+        : m_object(object),
+          m_method(method),
+          m_allocations(0)
+    {
+    }
+
+    RecurringEvent(const RecurringEvent&) = delete;
+    RecurringEvent& operator=(const RecurringEvent&) = delete;
+
+    /**
+     * Schedule a call of the method, like Simulator::Schedule().
+     *
+     * @param delay Delay from now.
+     * @return the event's id.
+     */
+    EventId Schedule(const Time& delay)
+    {
+        Ptr<Impl> event;
+        if (!m_free.empty())
+        {
+            event = m_free.back();
+            m_free.pop_back();
+        }
+        else
+        {
+            event = Create<Impl>(this);
+            ++m_allocations;
+        }
+        return Simulator::Schedule(delay, Ptr<EventImpl>(event));
+    }
+
+    /// @return the number of EventImpl objects allocated so far.
+    uint64_t GetAllocations() const
+    {
+        return m_allocations;
+    }
+
+  private:
+    class Impl : public EventImpl
+    {
+      public:
+        explicit Impl(RecurringEvent* owner)
+            : m_owner(owner)
+        {
+        }
+
+      private:
+        void Notify() override
+        {
+            // Free before the call, so a reschedule from the method reuses this object
+            m_owner->m_free.push_back(Ptr<Impl>(this));
+            (m_owner->m_object->*m_owner->m_method)();
+        }
+
+        RecurringEvent* m_owner;
+    };
+
+    T* m_object;
+    Method m_method;
+    std::vector<Ptr<Impl>> m_free;
+    uint64_t m_allocations;
+};
+
+} // namespace ns3
+
+#endif // SCRATCH_RECURRING_EVENT_H
@@ -0,0 +1,121 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "reliable-header.h"
+
+namespace ns3
+{
+
+NS_OBJECT_ENSURE_REGISTERED(ReliableHeader);
+
+ReliableHeader::ReliableHeader()
+    : m_sequenceNumber(0),
+      m_ackNumber(0),
+      m_sackBitmap(0),
+      m_isAck(false)
+{
+}
+
+ReliableHeader::~ReliableHeader()
+{
+}
+
+TypeId
+ReliableHeader::GetTypeId()
+{
+    static TypeId tid = TypeId("ReliableHeader")
+                            .SetParent<Header>()
+                            .SetGroupName("Applications")
+                            .AddConstructor<ReliableHeader>();
+    return tid;
+}
+
+TypeId
+ReliableHeader::GetInstanceTypeId() const
+{
+    return GetTypeId();
+}
+
+uint32_t
+ReliableHeader::GetSerializedSize() const
+{
+    return sizeof(m_sequenceNumber) + sizeof(m_ackNumber) + sizeof(m_sackBitmap) + sizeof(m_isAck);
+}
+
+void
+ReliableHeader::Serialize(Buffer::Iterator start) const
+{
+    start.WriteHtonU32(m_sequenceNumber);
+    start.WriteHtonU32(m_ackNumber);
+    start.WriteHtonU32(m_sackBitmap);
+    start.WriteU8(m_isAck ? 1 : 0);
+}
+
+uint32_t
+ReliableHeader::Deserialize(Buffer::Iterator start)
+{
+    m_sequenceNumber = start.ReadNtohU32();
+    m_ackNumber = start.ReadNtohU32();
+    m_sackBitmap = start.ReadNtohU32();
+    m_isAck = (start.ReadU8() == 1);
+    return GetSerializedSize();
+}
+
+void
+ReliableHeader::Print(std::ostream& os) const
+{
+    os << "Seq: " << m_sequenceNumber << " Ack: " << m_ackNumber
+       << " Sack: " << std::hex << m_sackBitmap << std::dec
+       << " IsAck: " << (m_isAck ? "true" : "false");
+}
+
+void
+ReliableHeader::SetSequenceNumber(uint32_t seq)
+{
+    m_sequenceNumber = seq;
+}
+
+uint32_t
+ReliableHeader::GetSequenceNumber() const
+{
+    return m_sequenceNumber;
+}
+
+void
+ReliableHeader::SetAckNumber(uint32_t ack)
+{
+    m_ackNumber = ack;
+}
+
+uint32_t
+ReliableHeader::GetAckNumber() const
+{
+    return m_ackNumber;
+}
+
+void
+ReliableHeader::SetIsAck(bool isAck)
+{
+    m_isAck = isAck;
+}
+
+bool
+ReliableHeader::GetIsAck() const
+{
+    return m_isAck;
+}
+
+void
+ReliableHeader::SetSackBitmap(uint32_t bitmap)
+{
+    m_sackBitmap = bitmap;
+}
+
+uint32_t
+ReliableHeader::GetSackBitmap() const
+{
+    return m_sackBitmap;
+}
+
+} // namespace ns3
@@ -0,0 +1,59 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// Packet header of the reliable transfer experiment (exp2).
+//
+// ACKs are cumulative: the ack number is the next sequence number the
+// receiver expects. With selective repeat, bit i of the SACK bitmap also
+// reports that ackNumber + 1 + i is buffered at the receiver.
+
+#ifndef SCRATCH_RELIABLE_HEADER_H
+#define SCRATCH_RELIABLE_HEADER_H
+
+#include "ns3/header.h"
+
+#include <cstdint>
+#include <ostream>
+
+namespace ns3
+{
+
+/**
+ * @brief Sequence/ACK header of the reliable transfer client and server.
+ */
+class ReliableHeader : public Header
+{
+  public:
+    ReliableHeader();
+    virtual ~ReliableHeader();
+
+    static TypeId GetTypeId();
+    virtual TypeId GetInstanceTypeId() const;
+    virtual uint32_t GetSerializedSize() const;
+    virtual void Serialize(Buffer::Iterator start) const;
+    virtual uint32_t Deserialize(Buffer::Iterator start);
+    virtual void Print(std::ostream& os) const;
+
+    void SetSequenceNumber(uint32_t seq);
+    uint32_t GetSequenceNumber() const;
+    void SetAckNumber(uint32_t ack);
+    uint32_t GetAckNumber() const;
+    void SetIsAck(bool isAck);
+    bool GetIsAck() const;
+    void SetSackBitmap(uint32_t bitmap);
+    uint32_t GetSackBitmap() const;
+
+    // Number of sequence numbers after the ack number covered by the bitmap
+    static const uint32_t SACK_BITS = 32;
+
+  private:
+    uint32_t m_sequenceNumber;
+    uint32_t m_ackNumber;
+    uint32_t m_sackBitmap;
+    bool m_isAck;
+};
+
+} // namespace ns3
+
+#endif // SCRATCH_RELIABLE_HEADER_H
@@ -0,0 +1,156 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "replication-stats.h"
+
+#include "ns3/fatal-error.h"
+
+#include <cmath>
+#include <iomanip>
+#include <limits>
+
+namespace ns3
+{
+
+namespace
+{
+
+// Two-sided 95% Student t quantiles for 1..30 degrees of freedom
+const double T_975[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+                        2.201,  2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+                        2.080,  2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+
+double
+StudentT975(uint32_t degreesOfFreedom)
+{
+    const uint32_t tableSize = sizeof(T_975) / sizeof(T_975[0]);
+    return degreesOfFreedom <= tableSize ? T_975[degreesOfFreedom - 1] : 1.960;
+}
+
+} // namespace
+
+RunningStats::RunningStats()
+    : m_count(0),
+      m_mean(0.0),
+      m_m2(0.0)
+{
+}
+
+void
+RunningStats::Add(double value)
+{
+    ++m_count;
+    double delta = value - m_mean;
+    m_mean += delta / m_count;
+    m_m2 += delta * (value - m_mean);
+}
+
+uint32_t
+RunningStats::GetCount() const
+{
+    return m_count;
+}
+
+double
+RunningStats::GetMean() const
+{
+    return m_mean;
+}
+
+double
+RunningStats::GetVariance() const
+{
+    return m_count > 1 ? m_m2 / (m_count - 1) : 0.0;
+}
+
+double
+RunningStats::GetHalfWidth() const
+{
+    if (m_count < 2)
+    {
+        return std::numeric_limits<double>::infinity();
+    }
+    return StudentT975(m_count - 1) * std::sqrt(GetVariance() / m_count);
+}
+
+void
+ReplicationStats::Add(const ResultRecord& record)
+{
+    size_t numeric = 0;
+    for (const auto& field : record.GetFields())
+    {
+        if (field.type == ResultRecord::STRING)
+        {
+            continue;
+        }
+        double value = field.type == ResultRecord::UINT ? static_cast<double>(field.u) : field.d;
+        if (m_count == 0)
+        {
+            m_fields.emplace_back(field.name, RunningStats());
+        }
+        else if (numeric >= m_fields.size() || m_fields[numeric].first != field.name)
+        {
+            NS_FATAL_ERROR("Replication record field " << field.name << " does not match the first record");
+        }
+        m_fields[numeric].second.Add(value);
+        ++numeric;
+    }
+    ++m_count;
+}
+
+uint32_t
+ReplicationStats::GetCount() const
+{
+    return m_count;
+}
+
+const RunningStats&
+ReplicationStats::Get(const std::string& name) const
+{
+    for (const auto& field : m_fields)
+    {
+        if (field.first == name)
+        {
+            return field.second;
+        }
+    }
+    NS_FATAL_ERROR("No numeric field " << name << " in the replication records");
+    return m_fields.front().second;
+}
+
+bool
+ReplicationStats::IsConverged(const std::vector<std::string>& metrics, double relativeHalfWidth) const
+{
+    for (const std::string& name : metrics)
+    {
+        const RunningStats& stats = Get(name);
+        double halfWidth = stats.GetHalfWidth();
+        if (halfWidth == 0.0)
+        {
+            continue;
+        }
+        if (!(halfWidth <= relativeHalfWidth * std::fabs(stats.GetMean())))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void
+ReplicationStats::Print(std::ostream& os) const
+{
+    std::ios::fmtflags flags = os.flags();
+    std::streamsize precision = os.precision();
+    os << std::setprecision(6);
+    for (const auto& field : m_fields)
+    {
+        os << "  " << std::left << std::setw(28) << field.first << std::right
+           << field.second.GetMean() << " +/- " << field.second.GetHalfWidth() << std::endl;
+    }
+    os.flags(flags);
+    os.precision(precision);
+}
+
+} // namespace ns3
@@ -0,0 +1,102 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// Mean and 95% confidence interval of every numeric field over independent
+// replications of one configuration.
+//
+// Each replication's ResultRecord is fed in as it completes; the fields are
+// accumulated with Welford's method, so nothing is stored per replication.
+// The interval is mean +/- t(0.975, n-1) * s / sqrt(n), which assumes the
+// replications are independent (distinct RngRun values) and roughly normal.
+
+#ifndef SCRATCH_REPLICATION_STATS_H
+#define SCRATCH_REPLICATION_STATS_H
+
+#include "result-writer.h"
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * @brief Running mean and variance of one metric.
+ */
+class RunningStats
+{
+  public:
+    RunningStats();
+
+    /// @param value Next sample.
+    void Add(double value);
+
+    /// @return the number of samples.
+    uint32_t GetCount() const;
+
+    /// @return the sample mean, 0 if empty.
+    double GetMean() const;
+
+    /// @return the unbiased sample variance, 0 with fewer than two samples.
+    double GetVariance() const;
+
+    /// @return the half-width of the 95% confidence interval of the mean;
+    ///         infinite with fewer than two samples.
+    double GetHalfWidth() const;
+
+  private:
+    uint32_t m_count;
+    double m_mean;
+    double m_m2;
+};
+
+/**
+ * @brief Confidence intervals of the numeric fields of replicated records.
+ */
+class ReplicationStats
+{
+  public:
+    /**
+     * Accumulate the UINT and DOUBLE fields of one replication. The first
+     * record fixes the field list; string fields are ignored.
+     *
+     * @param record Result of one replication.
+     */
+    void Add(const ResultRecord& record);
+
+    /// @return the number of replications added.
+    uint32_t GetCount() const;
+
+    /**
+     * @param name Field name.
+     * @return the statistics of that field; aborts if there is no such
+     *         numeric field.
+     */
+    const RunningStats& Get(const std::string& name) const;
+
+    /**
+     * @param metrics Field names to check.
+     * @param relativeHalfWidth Target half-width as a fraction of the mean.
+     * @return true if every metric's interval is within the target (a metric
+     *         whose mean and half-width are both 0 counts as converged).
+     */
+    bool IsConverged(const std::vector<std::string>& metrics, double relativeHalfWidth) const;
+
+    /**
+     * Print one "name mean +/- half-width" line per field.
+     *
+     * @param os Output stream.
+     */
+    void Print(std::ostream& os) const;
+
+  private:
+    std::vector<std::pair<std::string, RunningStats>> m_fields;
+    uint32_t m_count = 0;
+};
+
+} // namespace ns3
+
+#endif // SCRATCH_REPLICATION_STATS_H
@@ -0,0 +1,344 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "result-writer.h"
+
+#include "ns3/fatal-error.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+namespace ns3
+{
+
+namespace
+{
+
+const uint16_t BIN_FORMAT_VERSION = 1;
+
+template <typename T>
+void
+WriteLe(std::ostream& os, T value)
+{
+    unsigned char bytes[sizeof(T)];
+    for (size_t i = 0; i < sizeof(T); ++i)
+    {
+        bytes[i] = static_cast<unsigned char>(value >> (8 * i));
+    }
+    os.write(reinterpret_cast<const char*>(bytes), sizeof(T));
+}
+
+void
+WriteLeDouble(std::ostream& os, double value)
+{
+    uint64_t bits;
+    static_assert(sizeof(bits) == sizeof(value), "unexpected double size");
+    std::memcpy(&bits, &value, sizeof(bits));
+    WriteLe<uint64_t>(os, bits);
+}
+
+std::string
+FormatDouble(double value)
+{
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.10g", value);
+    return buffer;
+}
+
+std::string
+CsvEscape(const std::string& s)
+{
+    if (s.find_first_of(",\"\n\r") == std::string::npos)
+    {
+        return s;
+    }
+    std::string out = "\"";
+    for (char c : s)
+    {
+        if (c == '"')
+        {
+            out += '"';
+        }
+        out += c;
+    }
+    return out + "\"";
+}
+
+std::string
+JsonEscape(const std::string& s)
+{
+    std::string out = "\"";
+    for (unsigned char c : s)
+    {
+        switch (c)
+        {
+        case '"':
+            out += "\\\"";
+            break;
+        case '\\':
+            out += "\\\\";
+            break;
+        case '\n':
+            out += "\\n";
+            break;
+        case '\r':
+            out += "\\r";
+            break;
+        case '\t':
+            out += "\\t";
+            break;
+        default:
+            if (c < 0x20)
+            {
+                char buffer[8];
+                std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+                out += buffer;
+            }
+            else
+            {
+                out += static_cast<char>(c);
+            }
+        }
+    }
+    return out + "\"";
+}
+
+} // namespace
+
+ResultRecord&
+ResultRecord::AddUint(const std::string& name, uint64_t value)
+{
+    m_fields.push_back(Field{name, UINT, value, 0.0, std::string()});
+    return *this;
+}
+
+ResultRecord&
+ResultRecord::AddDouble(const std::string& name, double value)
+{
+    m_fields.push_back(Field{name, DOUBLE, 0, value, std::string()});
+    return *this;
+}
+
+ResultRecord&
+ResultRecord::AddString(const std::string& name, const std::string& value)
+{
+    m_fields.push_back(Field{name, STRING, 0, 0.0, value});
+    return *this;
+}
+
+const std::vector<ResultRecord::Field>&
+ResultRecord::GetFields() const
+{
+    return m_fields;
+}
+
+ResultWriter::ResultWriter(const std::string& format,
+                           const std::string& schema,
+                           uint32_t schemaVersion,
+                           const std::string& filename)
+    : m_format(ParseFormat(format)),
+      m_schema(schema),
+      m_schemaVersion(schemaVersion),
+      m_os(&std::cout),
+      m_headerWritten(false)
+{
+    if (m_format != TEXT && !filename.empty() && filename != "-")
+    {
+        std::ios::openmode mode = std::ios::out | std::ios::trunc;
+        if (m_format == BIN)
+        {
+            mode |= std::ios::binary;
+        }
+        m_file.open(filename, mode);
+        if (!m_file)
+        {
+            NS_FATAL_ERROR("Cannot open result file " << filename);
+        }
+        m_os = &m_file;
+    }
+}
+
+ResultWriter::Format
+ResultWriter::ParseFormat(const std::string& format)
+{
+    if (format == "text")
+    {
+        return TEXT;
+    }
+    else if (format == "csv")
+    {
+        return CSV;
+    }
+    else if (format == "jsonl")
+    {
+        return JSONL;
+    }
+    else if (format == "bin")
+    {
+        return BIN;
+    }
+    NS_FATAL_ERROR("Unknown result format '" << format << "' (expected text, csv, jsonl or bin)");
+    return TEXT;
+}
+
+bool
+ResultWriter::IsEnabled() const
+{
+    return m_format != TEXT;
+}
+
+ResultWriter::Format
+ResultWriter::GetFormat() const
+{
+    return m_format;
+}
+
+void
+ResultWriter::Flush()
+{
+    m_os->flush();
+}
+
+void
+ResultWriter::WriteHeader(const ResultRecord& record)
+{
+    for (const auto& field : record.GetFields())
+    {
+        m_layout.emplace_back(field.name, field.type);
+    }
+
+    std::ostream& os = *m_os;
+    if (m_format == CSV)
+    {
+        os << "schema,schemaVersion";
+        for (const auto& field : m_layout)
+        {
+            os << "," << CsvEscape(field.first);
+        }
+        os << "\n";
+    }
+    else if (m_format == BIN)
+    {
+        os.write("NS3R", 4);
+        WriteLe<uint16_t>(os, BIN_FORMAT_VERSION);
+        WriteLe<uint16_t>(os, m_schema.size());
+        os.write(m_schema.data(), m_schema.size());
+        WriteLe<uint32_t>(os, m_schemaVersion);
+        WriteLe<uint16_t>(os, m_layout.size());
+        for (const auto& field : m_layout)
+        {
+            WriteLe<uint8_t>(os, field.second);
+            WriteLe<uint16_t>(os, field.first.size());
+            os.write(field.first.data(), field.first.size());
+        }
+    }
+    m_headerWritten = true;
+}
+
+void
+ResultWriter::CheckSchema(const ResultRecord& record) const
+{
+    const auto& fields = record.GetFields();
+    bool match = fields.size() == m_layout.size();
+    for (size_t i = 0; match && i < fields.size(); ++i)
+    {
+        match = fields[i].name == m_layout[i].first && fields[i].type == m_layout[i].second;
+    }
+    if (!match)
+    {
+        NS_FATAL_ERROR("Result record does not match schema " << m_schema << " v"
+                                                              << m_schemaVersion);
+    }
+}
+
+void
+ResultWriter::Write(const ResultRecord& record)
+{
+    if (m_format == TEXT)
+    {
+        return;
+    }
+    if (!m_headerWritten)
+    {
+        WriteHeader(record);
+    }
+    CheckSchema(record);
+
+    std::ostream& os = *m_os;
+    const auto& fields = record.GetFields();
+    switch (m_format)
+    {
+    case CSV:
+        os << CsvEscape(m_schema) << "," << m_schemaVersion;
+        for (const auto& field : fields)
+        {
+            os << ",";
+            if (field.type == ResultRecord::UINT)
+            {
+                os << field.u;
+            }
+            else if (field.type == ResultRecord::DOUBLE)
+            {
+                os << FormatDouble(field.d);
+            }
+            else
+            {
+                os << CsvEscape(field.s);
+            }
+        }
+        os << "\n";
+        break;
+    case JSONL:
+        os << "{\"schema\":" << JsonEscape(m_schema) << ",\"schemaVersion\":" << m_schemaVersion;
+        for (const auto& field : fields)
+        {
+            os << "," << JsonEscape(field.name) << ":";
+            if (field.type == ResultRecord::UINT)
+            {
+                os << field.u;
+            }
+            else if (field.type == ResultRecord::DOUBLE)
+            {
+                if (std::isfinite(field.d))
+                {
+                    os << FormatDouble(field.d);
+                }
+                else
+                {
+                    os << "null";
+                }
+            }
+            else
+            {
+                os << JsonEscape(field.s);
+            }
+        }
+        os << "}\n";
+        break;
+    case BIN:
+        for (const auto& field : fields)
+        {
+            if (field.type == ResultRecord::UINT)
+            {
+                WriteLe<uint64_t>(os, field.u);
+            }
+            else if (field.type == ResultRecord::DOUBLE)
+            {
+                WriteLeDouble(os, field.d);
+            }
+            else
+            {
+                WriteLe<uint32_t>(os, field.s.size());
+                os.write(field.s.data(), field.s.size());
+            }
+        }
+        break;
+    case TEXT:
+        break;
+    }
+}
+
+} // namespace ns3
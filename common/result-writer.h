@@ -0,0 +1,132 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// Machine-readable result stream shared by the experiment binaries.
+//
+// Every record carries the schema name and version, followed by the fields in
+// the order they were added. The field list of the first record fixes the
+// schema for the rest of the stream.
+//
+// Formats:
+//  - csv:   header line, then one line per record
+//  - jsonl: one JSON object per line
+//  - bin:   little-endian, self-describing:
+//             "NS3R" | u16 format version | u16 schema length | schema
+//             | u32 schema version | u16 field count
+//             | per field: u8 type (1 = u64, 2 = f64, 3 = string)
+//                          u16 name length | name
+//           then per record, per field: u64 | f64 | (u32 length | bytes)
+//  - text:  disabled; the binary prints its human-readable report instead
+
+#ifndef SCRATCH_RESULT_WRITER_H
+#define SCRATCH_RESULT_WRITER_H
+
+#include <cstdint>
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * @brief One result record: an ordered list of typed, named fields.
+ */
+class ResultRecord
+{
+  public:
+    /// Field value types, numbered as in the binary format.
+    enum Type : uint8_t
+    {
+        UINT = 1,
+        DOUBLE = 2,
+        STRING = 3
+    };
+
+    /// One named field.
+    struct Field
+    {
+        std::string name;
+        Type type;
+        uint64_t u;
+        double d;
+        std::string s;
+    };
+
+    ResultRecord& AddUint(const std::string& name, uint64_t value);
+    ResultRecord& AddDouble(const std::string& name, double value);
+    ResultRecord& AddString(const std::string& name, const std::string& value);
+
+    /// @return the fields, in insertion order.
+    const std::vector<Field>& GetFields() const;
+
+  private:
+    std::vector<Field> m_fields;
+};
+
+/**
+ * @brief Writes schema-versioned result records in csv, jsonl or bin format.
+ */
+class ResultWriter
+{
+  public:
+    /// Output formats.
+    enum Format
+    {
+        TEXT,
+        CSV,
+        JSONL,
+        BIN
+    };
+
+    /**
+     * @param format One of "text", "csv", "jsonl", "bin".
+     * @param schema Schema name identifying the record layout.
+     * @param schemaVersion Bumped whenever fields change meaning or order.
+     * @param filename Output file; empty or "-" writes to standard output.
+     */
+    ResultWriter(const std::string& format,
+                 const std::string& schema,
+                 uint32_t schemaVersion,
+                 const std::string& filename = "");
+
+    /// @return true unless the format is "text".
+    bool IsEnabled() const;
+
+    /// @return the selected format.
+    Format GetFormat() const;
+
+    /**
+     * Write one record. Aborts if its fields do not match the first record.
+     *
+     * @param record The record to write.
+     */
+    void Write(const ResultRecord& record);
+
+    /// Flush the underlying stream.
+    void Flush();
+
+    /**
+     * @param format Format name.
+     * @return the parsed format; aborts on an unknown name.
+     */
+    static Format ParseFormat(const std::string& format);
+
+  private:
+    void WriteHeader(const ResultRecord& record);
+    void CheckSchema(const ResultRecord& record) const;
+
+    Format m_format;
+    std::string m_schema;
+    uint32_t m_schemaVersion;
+    std::ofstream m_file;
+    std::ostream* m_os;
+    bool m_headerWritten;
+    std::vector<std::pair<std::string, ResultRecord::Type>> m_layout;
+};
+
+} // namespace ns3
+
+#endif // SCRATCH_RESULT_WRITER_H
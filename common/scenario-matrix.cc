@@ -0,0 +1,222 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "scenario-matrix.h"
+
+#include "ns3/fatal-error.h"
+
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+namespace ns3
+{
+
+namespace
+{
+
+std::string
+Trim(const std::string& s)
+{
+    size_t begin = s.find_first_not_of(" \t\r\n");
+    if (begin == std::string::npos)
+    {
+        return "";
+    }
+    size_t end = s.find_last_not_of(" \t\r\n");
+    return s.substr(begin, end - begin + 1);
+}
+
+bool
+ParseInt(const std::string& s, int64_t& value)
+{
+    if (s.empty())
+    {
+        return false;
+    }
+    std::istringstream is(s);
+    is >> value;
+    return !is.fail() && is.eof();
+}
+
+} // namespace
+
+ScenarioMatrix::ScenarioMatrix()
+{
+}
+
+void
+ScenarioMatrix::Load(const std::string& filename)
+{
+    std::ifstream in(filename);
+    if (!in)
+    {
+        NS_FATAL_ERROR("Cannot open scenario matrix file " << filename);
+    }
+    std::string line;
+    uint32_t lineNumber = 0;
+    while (std::getline(in, line))
+    {
+        ++lineNumber;
+        size_t comment = line.find('#');
+        if (comment != std::string::npos)
+        {
+            line.erase(comment);
+        }
+        line = Trim(line);
+        if (line.empty())
+        {
+            continue;
+        }
+        size_t eq = line.find('=');
+        if (eq == std::string::npos)
+        {
+            NS_FATAL_ERROR(filename << ":" << lineNumber << ": expected 'axis = values'");
+        }
+        AddAxis(Trim(line.substr(0, eq)), line.substr(eq + 1));
+    }
+}
+
+void
+ScenarioMatrix::AddAxis(const std::string& name, const std::string& spec)
+{
+    if (name.empty())
+    {
+        NS_FATAL_ERROR("Scenario matrix axis without a name");
+    }
+    if (HasAxis(name))
+    {
+        NS_FATAL_ERROR("Scenario matrix axis " << name << " defined twice");
+    }
+
+    Axis axis;
+    axis.name = name;
+    axis.isRange = false;
+    axis.first = 0;
+    axis.step = 1;
+    axis.count = 0;
+
+    std::string value = Trim(spec);
+    size_t dots = value.find("..");
+    if (dots != std::string::npos && value.find(',') == std::string::npos)
+    {
+        std::string from = value.substr(0, dots);
+        std::string to = value.substr(dots + 2);
+        std::string step = "1";
+        size_t colon = to.find(':');
+        if (colon != std::string::npos)
+        {
+            step = to.substr(colon + 1);
+            to.erase(colon);
+        }
+        int64_t a;
+        int64_t b;
+        int64_t s;
+        if (!ParseInt(Trim(from), a) || !ParseInt(Trim(to), b) || !ParseInt(Trim(step), s) ||
+            s <= 0 || b < a)
+        {
+            NS_FATAL_ERROR("Invalid range '" << value << "' for axis " << name);
+        }
+        axis.isRange = true;
+        axis.first = a;
+        axis.step = s;
+        axis.count = static_cast<uint64_t>((b - a) / s) + 1;
+    }
+    else
+    {
+        std::istringstream is(value);
+        std::string item;
+        while (std::getline(is, item, ','))
+        {
+            item = Trim(item);
+            if (item.empty())
+            {
+                NS_FATAL_ERROR("Empty value in axis " << name);
+            }
+            axis.values.push_back(item);
+        }
+        if (axis.values.empty())
+        {
+            NS_FATAL_ERROR("Axis " << name << " has no values");
+        }
+    }
+
+    uint64_t size = GetSize();
+    uint64_t axisSize = GetAxisSize(axis);
+    if (size > std::numeric_limits<uint64_t>::max() / axisSize)
+    {
+        NS_FATAL_ERROR("Scenario matrix too large");
+    }
+    m_axes.push_back(axis);
+}
+
+uint64_t
+ScenarioMatrix::GetSize() const
+{
+    uint64_t size = 1;
+    for (const Axis& axis : m_axes)
+    {
+        size *= GetAxisSize(axis);
+    }
+    return size;
+}
+
+bool
+ScenarioMatrix::HasAxis(const std::string& name) const
+{
+    for (const Axis& axis : m_axes)
+    {
+        if (axis.name == name)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<std::string>
+ScenarioMatrix::GetAxisNames() const
+{
+    std::vector<std::string> names;
+    for (const Axis& axis : m_axes)
+    {
+        names.push_back(axis.name);
+    }
+    return names;
+}
+
+std::string
+ScenarioMatrix::Get(uint64_t index, const std::string& name, const std::string& defaultValue) const
+{
+    // Mixed-radix decode, last axis varying fastest.
+    for (size_t i = m_axes.size(); i-- > 0;)
+    {
+        const Axis& axis = m_axes[i];
+        uint64_t axisSize = GetAxisSize(axis);
+        if (axis.name == name)
+        {
+            return GetAxisValue(axis, index % axisSize);
+        }
+        index /= axisSize;
+    }
+    return defaultValue;
+}
+
+uint64_t
+ScenarioMatrix::GetAxisSize(const Axis& axis) const
+{
+    return axis.isRange ? axis.count : axis.values.size();
+}
+
+std::string
+ScenarioMatrix::GetAxisValue(const Axis& axis, uint64_t i) const
+{
+    if (axis.isRange)
+    {
+        return std::to_string(axis.first + static_cast<int64_t>(i) * axis.step);
+    }
+    return axis.values[i];
+}
+
+} // namespace ns3
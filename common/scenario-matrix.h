@@ -0,0 +1,93 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// Declarative parameter matrix: a cartesian product of named axes read from a
+// small text file. Points are decoded on demand from their index, so a matrix of
+// millions of combinations costs only the memory of its axis definitions.
+//
+// File format (one axis per line, '#' starts a comment):
+//
+//   dataRate = 1Mbps, 5Mbps, 10Mbps
+//   errorRate = 0, 0.001, 0.01
+//   seeds = 1..20
+//
+// An integer range "a..b" (optionally "a..b:step") is kept as a range and never
+// expanded. The first axis varies slowest.
+
+#ifndef SCRATCH_SCENARIO_MATRIX_H
+#define SCRATCH_SCENARIO_MATRIX_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * @brief Lazily expanded cartesian product of parameter axes.
+ */
+class ScenarioMatrix
+{
+  public:
+    ScenarioMatrix();
+
+    /**
+     * Parse a matrix file. Aborts the program with NS_FATAL_ERROR on a
+     * malformed file.
+     *
+     * @param filename Path of the matrix file.
+     */
+    void Load(const std::string& filename);
+
+    /**
+     * Add an axis programmatically.
+     *
+     * @param name Axis name.
+     * @param spec Comma separated values or an integer range.
+     */
+    void AddAxis(const std::string& name, const std::string& spec);
+
+    /// @return the number of points in the matrix (product of axis sizes).
+    uint64_t GetSize() const;
+
+    /// @return true if an axis with this name exists.
+    bool HasAxis(const std::string& name) const;
+
+    /// @return the axis names, in file order.
+    std::vector<std::string> GetAxisNames() const;
+
+    /**
+     * Get the value of one axis at a matrix point.
+     *
+     * @param index Point index in [0, GetSize()).
+     * @param name Axis name.
+     * @param defaultValue Returned if the matrix has no such axis.
+     * @return the value, as written in the file.
+     */
+    std::string Get(uint64_t index,
+                    const std::string& name,
+                    const std::string& defaultValue = "") const;
+
+  private:
+    /// One axis: either explicit values or an integer range.
+    struct Axis
+    {
+        std::string name;
+        std::vector<std::string> values;
+        bool isRange;
+        int64_t first;
+        int64_t step;
+        uint64_t count;
+    };
+
+    uint64_t GetAxisSize(const Axis& axis) const;
+    std::string GetAxisValue(const Axis& axis, uint64_t i) const;
+
+    std::vector<Axis> m_axes;
+};
+
+} // namespace ns3
+
+#endif // SCRATCH_SCENARIO_MATRIX_H
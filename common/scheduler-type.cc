@@ -0,0 +1,58 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "scheduler-type.h"
+
+#include "ns3/fatal-error.h"
+#include "ns3/global-value.h"
+#include "ns3/type-id.h"
+
+namespace ns3
+{
+
+namespace
+{
+
+const char* const SCHEDULER_TYPE_NAMES = "map, list, heap, calendar or priority";
+
+} // namespace
+
+void
+SetSchedulerType(const std::string& name)
+{
+    std::string typeName;
+    if (name == "map")
+    {
+        typeName = "ns3::MapScheduler";
+    }
+    else if (name == "list")
+    {
+        typeName = "ns3::ListScheduler";
+    }
+    else if (name == "heap")
+    {
+        typeName = "ns3::HeapScheduler";
+    }
+    else if (name == "calendar")
+    {
+        typeName = "ns3::CalendarScheduler";
+    }
+    else if (name == "priority")
+    {
+        typeName = "ns3::PriorityQueueScheduler";
+    }
+    else if (name == "ladder")
+    {
+        NS_FATAL_ERROR("ns-3 has no ladder queue scheduler (expected " << SCHEDULER_TYPE_NAMES
+                                                                       << ")");
+    }
+    else
+    {
+        NS_FATAL_ERROR("Unknown scheduler: " << name << " (expected " << SCHEDULER_TYPE_NAMES
+                                             << ")");
+    }
+    GlobalValue::Bind("SchedulerType", TypeIdValue(TypeId::LookupByName(typeName)));
+}
+
+} // namespace ns3
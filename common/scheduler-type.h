@@ -0,0 +1,36 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// Event scheduler selection for the experiment binaries (--scheduler).
+//
+// ns-3 runs on MapScheduler (a std::map) unless told otherwise. High-rate
+// scenarios spend much of their time inserting and removing events, and the
+// other schedulers trade differently: heap and priority (binary heaps) keep
+// the queue contiguous, calendar buckets events by time and is O(1) when they
+// are spread evenly, list is a sorted list (only for tiny queues). All of
+// them execute events in the same order, so the choice changes speed, never
+// results. ns-3 has no ladder queue.
+//
+// The choice is bound to the "SchedulerType" global value, so it also
+// applies to every simulation after a Simulator::Destroy() and in forked
+// workers.
+
+#ifndef SCRATCH_SCHEDULER_TYPE_H
+#define SCRATCH_SCHEDULER_TYPE_H
+
+#include <string>
+
+namespace ns3
+{
+
+/**
+ * Select the event scheduler of all later simulations.
+ *
+ * @param name map, list, heap, calendar or priority; aborts on any other name.
+ */
+void SetSchedulerType(const std::string& name);
+
+} // namespace ns3
+
+#endif // SCRATCH_SCHEDULER_TYPE_H
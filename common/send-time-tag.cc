@@ -0,0 +1,74 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "send-time-tag.h"
+
+namespace ns3
+{
+
+NS_OBJECT_ENSURE_REGISTERED(SendTimeTag);
+
+SendTimeTag::SendTimeTag()
+    : m_sendTime(Seconds(0))
+{
+}
+
+SendTimeTag::SendTimeTag(Time sendTime)
+    : m_sendTime(sendTime)
+{
+}
+
+TypeId
+SendTimeTag::GetTypeId()
+{
+    static TypeId tid = TypeId("SendTimeTag")
+                            .SetParent<Tag>()
+                            .SetGroupName("Applications")
+                            .AddConstructor<SendTimeTag>();
+    return tid;
+}
+
+TypeId
+SendTimeTag::GetInstanceTypeId() const
+{
+    return GetTypeId();
+}
+
+uint32_t
+SendTimeTag::GetSerializedSize() const
+{
+    return sizeof(int64_t);
+}
+
+void
+SendTimeTag::Serialize(TagBuffer i) const
+{
+    i.WriteU64(static_cast<uint64_t>(m_sendTime.GetTimeStep()));
+}
+
+void
+SendTimeTag::Deserialize(TagBuffer i)
+{
+    m_sendTime = TimeStep(i.ReadU64());
+}
+
+void
+SendTimeTag::Print(std::ostream& os) const
+{
+    os << "SendTime=" << m_sendTime;
+}
+
+void
+SendTimeTag::SetSendTime(Time sendTime)
+{
+    m_sendTime = sendTime;
+}
+
+Time
+SendTimeTag::GetSendTime() const
+{
+    return m_sendTime;
+}
+
+} // namespace ns3
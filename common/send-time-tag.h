@@ -0,0 +1,55 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// Send-time byte tag for one-way delay measurement.
+//
+// Added as a byte tag over the bytes an application writes, the tag follows
+// those bytes through TCP segmentation, retransmission and reassembly, so the
+// receiver can recover the send time of every byte range it reads back. The
+// time is carried as a raw TimeStep, so it stays exact across MPI ranks.
+
+#ifndef SCRATCH_SEND_TIME_TAG_H
+#define SCRATCH_SEND_TIME_TAG_H
+
+#include "ns3/nstime.h"
+#include "ns3/tag.h"
+
+namespace ns3
+{
+
+/**
+ * @brief Byte tag carrying the time the tagged bytes were handed to the socket.
+ */
+class SendTimeTag : public Tag
+{
+  public:
+    SendTimeTag();
+
+    /// @param sendTime Send time to carry.
+    explicit SendTimeTag(Time sendTime);
+
+    /**
+     * @brief Get the type ID.
+     * @return the object TypeId
+     */
+    static TypeId GetTypeId();
+    TypeId GetInstanceTypeId() const override;
+    uint32_t GetSerializedSize() const override;
+    void Serialize(TagBuffer i) const override;
+    void Deserialize(TagBuffer i) override;
+    void Print(std::ostream& os) const override;
+
+    /// @param sendTime Send time to carry.
+    void SetSendTime(Time sendTime);
+
+    /// @return the carried send time.
+    Time GetSendTime() const;
+
+  private:
+    Time m_sendTime;
+};
+
+} // namespace ns3
+
+#endif // SCRATCH_SEND_TIME_TAG_H
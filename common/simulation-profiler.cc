@@ -0,0 +1,117 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "simulation-profiler.h"
+
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+
+#include <chrono>
+#include <sys/resource.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace ns3
+{
+
+double SimulationProfiler::s_cpuAtLastRunEnd = 0.0;
+int SimulationProfiler::s_pidAtLastRunEnd = 0;
+
+double
+SimulationProfile::GetEventsPerSecond() const
+{
+    return wallSeconds > 0 ? events / wallSeconds : 0.0;
+}
+
+double
+SimulationProfile::GetSimRealRatio() const
+{
+    return wallSeconds > 0 ? simulatedSeconds / wallSeconds : 0.0;
+}
+
+void
+SimulationProfile::AddToRecord(ResultRecord& record) const
+{
+    record.AddUint("events", events)
+        .AddDouble("wallClock", wallSeconds)
+        .AddDouble("eventsPerSecond", GetEventsPerSecond())
+        .AddDouble("simRealRatio", GetSimRealRatio())
+        .AddUint("peakRssKb", peakRssKb)
+        .AddUint("packetsCreated", packetsCreated)
+        .AddDouble("timeToFirstEvent", timeToFirstEvent);
+}
+
+void
+SimulationProfile::Print(std::ostream& os) const
+{
+    os << "Simulator cost: " << events << " events in " << wallSeconds << " s wall clock ("
+       << GetEventsPerSecond() << " events/s, " << GetSimRealRatio()
+       << "x real time), peak RSS " << peakRssKb << " KiB, " << packetsCreated
+       << " packets created, " << timeToFirstEvent << " s CPU before the first event"
+       << std::endl;
+}
+
+uint64_t
+SimulationProfiler::GetNextPacketUid()
+{
+    // Every new Packet takes the next global uid, so a probe packet reads it
+    return Create<Packet>()->GetUid();
+}
+
+uint64_t
+SimulationProfiler::GetPeakRssKb()
+{
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+    {
+        return 0;
+    }
+    return static_cast<uint64_t>(usage.ru_maxrss); // KiB on Linux
+}
+
+double
+SimulationProfiler::GetProcessCpuSeconds()
+{
+    struct timespec now;
+    if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now) != 0)
+    {
+        return 0.0;
+    }
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+void
+SimulationProfiler::Run()
+{
+    // A forked child's CPU clock restarts at zero
+    if (s_pidAtLastRunEnd != getpid())
+    {
+        s_cpuAtLastRunEnd = 0.0;
+    }
+    m_profile.timeToFirstEvent = GetProcessCpuSeconds() - s_cpuAtLastRunEnd;
+    Time simStart = Simulator::Now();
+    uint64_t eventsBefore = Simulator::GetEventCount();
+    uint64_t uidBefore = GetNextPacketUid();
+    auto wallStart = std::chrono::steady_clock::now();
+
+    Simulator::Run();
+
+    m_profile.wallSeconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    m_profile.events = Simulator::GetEventCount() - eventsBefore;
+    m_profile.simulatedSeconds = (Simulator::Now() - simStart).GetSeconds();
+    // Both probes took a uid of their own
+    m_profile.packetsCreated = GetNextPacketUid() - uidBefore - 1;
+    m_profile.peakRssKb = GetPeakRssKb();
+    s_cpuAtLastRunEnd = GetProcessCpuSeconds();
+    s_pidAtLastRunEnd = getpid();
+}
+
+const SimulationProfile&
+SimulationProfiler::GetProfile() const
+{
+    return m_profile;
+}
+
+} // namespace ns3
@@ -0,0 +1,95 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// Self-profiling wrapper around Simulator::Run().
+//
+// Measures what one simulation run cost: wall-clock time, events executed,
+// events per wall-clock second, simulated-to-real time ratio, the process's
+// peak resident set size and the number of Packet objects created (fresh
+// packet uids; copies and fragments share their original's uid and are not
+// counted). The figures go into the experiment's own result record, so
+// scenario performance can be tracked next to the network metrics.
+//
+// Peak RSS is the high-water mark of the whole process (getrusage) and never
+// decreases, so in batch or replication mode it covers all runs so far; the
+// forked workers of lab3_tcp_udp_comparison each report their own.
+//
+// Time to first event is the CPU time the process spent before the run's
+// first event: for the first run of a process it covers dynamic loading,
+// static TypeId registration and scenario setup (what dominates tiny
+// scenarios), for later runs the setup since the previous run ended. It is
+// read from the process CPU clock, which starts at exec (and again at fork),
+// so time blocked on I/O is not included.
+
+#ifndef SCRATCH_SIMULATION_PROFILER_H
+#define SCRATCH_SIMULATION_PROFILER_H
+
+#include "result-writer.h"
+
+#include <cstdint>
+#include <ostream>
+
+namespace ns3
+{
+
+/**
+ * @brief Cost of one simulation run (plain data, safe to copy as bytes).
+ */
+struct SimulationProfile
+{
+    double wallSeconds = 0.0;
+    uint64_t events = 0;
+    double simulatedSeconds = 0.0;
+    uint64_t peakRssKb = 0;
+    uint64_t packetsCreated = 0;
+    double timeToFirstEvent = 0.0; // CPU seconds, see above
+
+    /// @return events executed per wall-clock second.
+    double GetEventsPerSecond() const;
+
+    /// @return simulated seconds per wall-clock second.
+    double GetSimRealRatio() const;
+
+    /**
+     * Append events, wallClock, eventsPerSecond, simRealRatio, peakRssKb,
+     * packetsCreated and timeToFirstEvent to @p record.
+     *
+     * @param record Result record of the run.
+     */
+    void AddToRecord(ResultRecord& record) const;
+
+    /**
+     * Print a one-line human-readable summary.
+     *
+     * @param os Output stream.
+     */
+    void Print(std::ostream& os) const;
+};
+
+/**
+ * @brief Runs the simulator and measures its cost.
+ */
+class SimulationProfiler
+{
+  public:
+    /// Run Simulator::Run() and record its profile.
+    void Run();
+
+    /// @return the profile of the last Run().
+    const SimulationProfile& GetProfile() const;
+
+  private:
+    static uint64_t GetNextPacketUid();
+    static uint64_t GetPeakRssKb();
+    static double GetProcessCpuSeconds();
+
+    static double s_cpuAtLastRunEnd; ///< process CPU clock when a Run() last returned
+    static int s_pidAtLastRunEnd;    ///< process that value belongs to
+
+    SimulationProfile m_profile;
+};
+
+} // namespace ns3
+
+#endif // SCRATCH_SIMULATION_PROFILER_H
@@ -0,0 +1,148 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "steady-state-monitor.h"
+
+#include "ns3/simulator.h"
+
+#include <limits>
+
+namespace ns3
+{
+
+SteadyStateMonitor::SteadyStateMonitor(Counter counter,
+                                       Time sampleInterval,
+                                       uint32_t minBatches,
+                                       bool stopWhenSteady)
+    : m_counter(counter),
+      m_sampleInterval(sampleInterval),
+      m_minBatches(minBatches),
+      m_stopWhenSteady(stopWhenSteady),
+      m_lastValue(0.0),
+      m_truncation(0),
+      m_steady(false)
+{
+}
+
+SteadyStateMonitor::~SteadyStateMonitor()
+{
+    Simulator::Cancel(m_event);
+}
+
+void
+SteadyStateMonitor::Start(Time start)
+{
+    m_start = start;
+    m_last = start;
+    m_event = Simulator::Schedule(start - Simulator::Now(), &SteadyStateMonitor::Sample, this);
+}
+
+void
+SteadyStateMonitor::Sample()
+{
+    double value = m_counter();
+    Time now = Simulator::Now();
+    if (now > m_start)
+    {
+        m_rates.push_back((value - m_lastValue) / m_sampleInterval.GetSeconds());
+        if (m_rates.size() % BATCH_SIZE == 0)
+        {
+            double sum = 0.0;
+            for (size_t i = m_rates.size() - BATCH_SIZE; i < m_rates.size(); ++i)
+            {
+                sum += m_rates[i];
+            }
+            m_batchMeans.push_back(sum / BATCH_SIZE);
+            Check();
+        }
+    }
+    m_lastValue = value;
+    m_last = now;
+    if (!m_steady || !m_stopWhenSteady)
+    {
+        m_event = Simulator::Schedule(m_sampleInterval, &SteadyStateMonitor::Sample, this);
+    }
+}
+
+void
+SteadyStateMonitor::Check()
+{
+    if (m_steady)
+    {
+        return;
+    }
+    m_truncation = MserTruncation(m_batchMeans);
+    if (m_batchMeans.size() - m_truncation >= m_minBatches)
+    {
+        m_steady = true;
+        if (m_stopWhenSteady)
+        {
+            Simulator::Stop();
+        }
+    }
+}
+
+uint32_t
+SteadyStateMonitor::MserTruncation(const std::vector<double>& batchMeans)
+{
+    // Suffix sums give every MSER(d) in one backward pass
+    uint32_t n = batchMeans.size();
+    uint32_t best = 0;
+    double bestValue = std::numeric_limits<double>::infinity();
+    double sum = 0.0;
+    double sumSquares = 0.0;
+    for (uint32_t d = n; d-- > 0;)
+    {
+        sum += batchMeans[d];
+        sumSquares += batchMeans[d] * batchMeans[d];
+        if (d > n / 2)
+        {
+            continue;
+        }
+        double m = n - d;
+        double value = (sumSquares - sum * sum / m) / (m * m);
+        if (value <= bestValue)
+        {
+            bestValue = value;
+            best = d;
+        }
+    }
+    return best;
+}
+
+bool
+SteadyStateMonitor::IsSteady() const
+{
+    return m_steady;
+}
+
+double
+SteadyStateMonitor::GetSteadyRate() const
+{
+    size_t first = m_steady ? m_truncation * BATCH_SIZE : 0;
+    if (first >= m_rates.size())
+    {
+        return 0.0;
+    }
+    double sum = 0.0;
+    for (size_t i = first; i < m_rates.size(); ++i)
+    {
+        sum += m_rates[i];
+    }
+    return sum / (m_rates.size() - first);
+}
+
+Time
+SteadyStateMonitor::GetWarmupEnd() const
+{
+    return m_start + m_sampleInterval * static_cast<int64_t>(m_steady ? m_truncation * BATCH_SIZE : 0);
+}
+
+Time
+SteadyStateMonitor::GetLastSample() const
+{
+    return m_last;
+}
+
+} // namespace ns3
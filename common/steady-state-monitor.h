@@ -0,0 +1,102 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// Steady-state detection with MSER-5 warm-up truncation.
+//
+// The monitor samples a cumulative counter (bytes received, packets
+// delivered, ...) at a fixed interval and turns it into a per-interval rate.
+// Rates are grouped in batches of five; after every batch the MSER statistic
+//
+//   MSER(d) = sum_{j >= d} (z_j - mean_d)^2 / (n - d)^2
+//
+// over the batch means z_0..z_{n-1} picks the warm-up length d* that
+// minimises it (searched over the first half, as usual). Once d* leaves at
+// least MinBatches batches after it, the run is declared steady, the
+// simulation is stopped, and the steady rate is the mean after d*.
+
+#ifndef SCRATCH_STEADY_STATE_MONITOR_H
+#define SCRATCH_STEADY_STATE_MONITOR_H
+
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * @brief Stops a simulation once a sampled rate has reached steady state.
+ */
+class SteadyStateMonitor
+{
+  public:
+    /// Returns the current value of a cumulative counter.
+    using Counter = std::function<double()>;
+
+    /// Samples per MSER batch.
+    static const uint32_t BATCH_SIZE = 5;
+
+    /**
+     * @param counter Cumulative quantity to monitor.
+     * @param sampleInterval Time between samples.
+     * @param minBatches Batches required after the warm-up before stopping.
+     * @param stopWhenSteady If false, only measure; never stop the simulation.
+     */
+    SteadyStateMonitor(Counter counter,
+                       Time sampleInterval,
+                       uint32_t minBatches = 10,
+                       bool stopWhenSteady = true);
+
+    ~SteadyStateMonitor();
+
+    /**
+     * Take the first sample at @p start.
+     *
+     * @param start Absolute simulation time of the first sample.
+     */
+    void Start(Time start);
+
+    /// @return true once steady state was detected.
+    bool IsSteady() const;
+
+    /// @return the mean rate (counter units per second) after the warm-up,
+    ///         or over all samples if steady state was never reached.
+    double GetSteadyRate() const;
+
+    /// @return the simulation time at which the warm-up ends.
+    Time GetWarmupEnd() const;
+
+    /// @return the simulation time of the last sample.
+    Time GetLastSample() const;
+
+    /**
+     * @param batchMeans Batch means z_0..z_{n-1}.
+     * @return the MSER-optimal number of leading batches to drop.
+     */
+    static uint32_t MserTruncation(const std::vector<double>& batchMeans);
+
+  private:
+    void Sample();
+    void Check();
+
+    Counter m_counter;
+    Time m_sampleInterval;
+    uint32_t m_minBatches;
+    bool m_stopWhenSteady;
+    EventId m_event;
+    Time m_start;
+    Time m_last;
+    double m_lastValue;
+    std::vector<double> m_rates;
+    std::vector<double> m_batchMeans;
+    uint32_t m_truncation; // in batches
+    bool m_steady;
+};
+
+} // namespace ns3
+
+#endif // SCRATCH_STEADY_STATE_MONITOR_H
@@ -0,0 +1,219 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "work-stealing-pool.h"
+
+#include "ns3/fatal-error.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace ns3
+{
+
+namespace
+{
+
+/// A range [begin, end) of task indices packed into one word, so that the
+/// owner taking the front and a thief taking the back half are each a single
+/// compare-and-swap.
+class TaskRange
+{
+  public:
+    TaskRange()
+        : m_range(0)
+    {
+    }
+
+    void Set(uint64_t begin, uint64_t end)
+    {
+        m_range.store(Pack(begin, end), std::memory_order_release);
+    }
+
+    /// Take the first task; false if the range is empty.
+    bool TakeFront(uint64_t& index)
+    {
+        uint64_t range = m_range.load(std::memory_order_acquire);
+        while (Begin(range) < End(range))
+        {
+            if (m_range.compare_exchange_weak(range,
+                                              Pack(Begin(range) + 1, End(range)),
+                                              std::memory_order_acq_rel))
+            {
+                index = Begin(range);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// Take the back half (at least one task); false if the range is empty.
+    bool StealBack(uint64_t& begin, uint64_t& end)
+    {
+        uint64_t range = m_range.load(std::memory_order_acquire);
+        while (Begin(range) < End(range))
+        {
+            uint64_t middle = Begin(range) + (End(range) - Begin(range)) / 2;
+            if (m_range.compare_exchange_weak(range,
+                                              Pack(Begin(range), middle),
+                                              std::memory_order_acq_rel))
+            {
+                begin = middle;
+                end = End(range);
+                return true;
+            }
+        }
+        return false;
+    }
+
+  private:
+    static uint64_t Pack(uint64_t begin, uint64_t end)
+    {
+        return begin << 32 | end;
+    }
+
+    static uint64_t Begin(uint64_t range)
+    {
+        return range >> 32;
+    }
+
+    static uint64_t End(uint64_t range)
+    {
+        return range & 0xffffffff;
+    }
+
+    std::atomic<uint64_t> m_range;
+};
+
+/// State shared by the threads of one Run().
+struct SharedRun
+{
+    SharedRun(uint64_t nTasks, uint32_t threads)
+        : ranges(threads),
+          results(nTasks),
+          ready(new std::atomic<bool>[nTasks])
+    {
+        for (uint64_t i = 0; i < nTasks; ++i)
+        {
+            ready[i].store(false, std::memory_order_relaxed);
+        }
+    }
+
+    std::vector<TaskRange> ranges;
+    std::vector<std::string> results;
+    std::unique_ptr<std::atomic<bool>[]> ready;
+};
+
+/// Run the tasks of thread @p self, then steal until every range is empty.
+/// @p afterTask runs after each task (the calling thread emits results there).
+template <typename AfterTask>
+void
+WorkLoop(SharedRun& run, uint32_t self, WorkStealingPool::Task& task, AfterTask afterTask)
+{
+    uint32_t threads = run.ranges.size();
+    for (;;)
+    {
+        uint64_t index;
+        while (run.ranges[self].TakeFront(index))
+        {
+            run.results[index] = task(index);
+            run.ready[index].store(true, std::memory_order_release);
+            afterTask();
+        }
+
+        // Own range is empty, so no other thread modifies it until it is set.
+        // No logging here: an NS_LOG time prefix would touch the simulator.
+        bool stolen = false;
+        for (uint32_t k = 1; k < threads && !stolen; ++k)
+        {
+            uint64_t begin;
+            uint64_t end;
+            stolen = run.ranges[(self + k) % threads].StealBack(begin, end);
+            if (stolen)
+            {
+                run.ranges[self].Set(begin, end);
+            }
+        }
+        if (!stolen)
+        {
+            return;
+        }
+    }
+}
+
+} // namespace
+
+WorkStealingPool::WorkStealingPool(uint32_t threads)
+    : m_threads(threads)
+{
+    if (m_threads == 0)
+    {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        m_threads = cpus > 0 ? static_cast<uint32_t>(cpus) : 1;
+    }
+}
+
+uint32_t
+WorkStealingPool::GetThreads() const
+{
+    return m_threads;
+}
+
+void
+WorkStealingPool::Run(uint64_t nTasks, Task task, Sink sink)
+{
+    if (m_threads <= 1 || nTasks <= 1)
+    {
+        for (uint64_t i = 0; i < nTasks; ++i)
+        {
+            sink(i, task(i));
+        }
+        return;
+    }
+    if (nTasks > std::numeric_limits<uint32_t>::max())
+    {
+        NS_FATAL_ERROR("Too many tasks for the thread pool: " << nTasks);
+    }
+
+    uint32_t threads = static_cast<uint32_t>(std::min<uint64_t>(m_threads, nTasks));
+    SharedRun run(nTasks, threads);
+    for (uint32_t t = 0; t < threads; ++t)
+    {
+        run.ranges[t].Set(nTasks * t / threads, nTasks * (t + 1) / threads);
+    }
+
+    // Results that finished ahead of the next index wait in their slots
+    uint64_t nextEmit = 0;
+    auto emitReady = [&]() {
+        while (nextEmit < nTasks && run.ready[nextEmit].load(std::memory_order_acquire))
+        {
+            sink(nextEmit, run.results[nextEmit]);
+            std::string().swap(run.results[nextEmit]);
+            ++nextEmit;
+        }
+    };
+
+    std::vector<std::thread> helpers;
+    for (uint32_t t = 1; t < threads; ++t)
+    {
+        helpers.emplace_back([&run, t, &task]() { WorkLoop(run, t, task, []() {}); });
+    }
+    WorkLoop(run, 0, task, emitReady);
+    while (nextEmit < nTasks)
+    {
+        std::this_thread::yield();
+        emitReady();
+    }
+    for (std::thread& helper : helpers)
+    {
+        helper.join();
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,70 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// Runs independent tasks on a fixed set of threads in this process, with the
+// same interface as ForkWorkerPool but without a process (and its copy of
+// the ns-3 state) per worker.
+//
+// Only tasks that never touch the simulator may run here: Simulator, the
+// node list, the Config and attribute system and the reference counts of
+// ns-3 objects are process-wide and not thread-safe, so packet-level
+// scenarios still need ForkWorkerPool.
+//
+// Each thread starts with a contiguous range of task indices and takes
+// tasks from its front; a thread whose range is empty steals the back half
+// of another thread's range. Both are a compare-and-swap on the victim's
+// packed range, so no locks are taken. Every task writes its result into its
+// own slot and marks it ready; the calling thread, itself one of the
+// workers, hands the ready prefix to the sink in task order.
+
+#ifndef SCRATCH_WORK_STEALING_POOL_H
+#define SCRATCH_WORK_STEALING_POOL_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace ns3
+{
+
+/**
+ * @brief Fixed-size work-stealing pool of threads for simulator-free tasks.
+ *
+ * With a single thread the tasks run in the calling thread, one after another.
+ */
+class WorkStealingPool
+{
+  public:
+    /// Computes the serialized result of task @p index (runs on any thread).
+    using Task = std::function<std::string(uint64_t index)>;
+    /// Consumes the result of task @p index (runs in the calling thread, in order).
+    using Sink = std::function<void(uint64_t index, const std::string& payload)>;
+
+    /**
+     * @param threads Number of threads, the calling one included; 0 selects
+     *                the number of online CPUs.
+     */
+    explicit WorkStealingPool(uint32_t threads);
+
+    /**
+     * Run tasks [0, nTasks) and deliver their results in index order.
+     *
+     * The task body must be safe to call concurrently from several threads.
+     *
+     * @param nTasks Number of tasks (below 2^32).
+     * @param task Task body.
+     * @param sink Result consumer.
+     */
+    void Run(uint64_t nTasks, Task task, Sink sink);
+
+    /// @return the effective number of threads.
+    uint32_t GetThreads() const;
+
+  private:
+    uint32_t m_threads;
+};
+
+} // namespace ns3
+
+#endif // SCRATCH_WORK_STEALING_POOL_H
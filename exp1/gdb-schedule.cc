@@ -4,6 +4,14 @@
 #include "ns3/point-to-point-module.h"
 #include "ns3/applications-module.h"
 
+#include "../common/binary-tracer.h"
+#include "../common/recurring-event.h"
+#include "../common/scheduler-type.h"
+#include "../common/simulation-profiler.h"
+
+#include <iostream>
+#include <memory>
+
 using namespace ns3;
 
 NS_LOG_COMPONENT_DEFINE("Task6Debug");
@@ -11,7 +19,7 @@ NS_LOG_COMPONENT_DEFINE("Task6Debug");
 class MyDebugApp : public Application
 {
 public:
-    MyDebugApp() : m_count(0) {}
+    MyDebugApp() : m_count(0), m_printEvents(this, &MyDebugApp::PrintTime) {}
     virtual ~MyDebugApp() {}
 
 private:
@@ -30,7 +38,7 @@ private:
     {
         if (m_count < 5)
         {
-            Simulator::Schedule(Seconds(1.0), &MyDebugApp::PrintTime, this);
+            m_printEvents.Schedule(Seconds(1.0));
         }
     }
 
@@ -52,6 +60,8 @@ private:
     }
 
     uint32_t m_count;
+    // 每次触发后重新调度，复用同一个事件对象（见 recurring-event.h）
+    RecurringEvent<MyDebugApp> m_printEvents;
 };
 
 int main(int argc, char* argv[])
@@ -59,8 +69,19 @@ int main(int argc, char* argv[])
     Time::SetResolution(Time::NS);
     LogComponentEnable("Task6Debug", LOG_LEVEL_INFO);
 
+    // binary：紧凑二进制跟踪（可用 binary-trace-convert 转换为 ASCII/pcap）
+    std::string tracing = "binary";
+    // 输出仿真开销（首个事件前的启动时间、事件数、墙钟时间），用于回归探测启动开销
+    bool profile = false;
+    // 事件调度器（map、list、heap、calendar、priority），只影响速度，不影响事件顺序
+    std::string scheduler = "map";
+
     CommandLine cmd(__FILE__);
+    cmd.AddValue("tracing", "Trace output (binary: task8-p2p.bt, ascii: task8-p2p.tr, pcap, none)", tracing);
+    cmd.AddValue("profile", "Print the simulator cost, including the CPU time before the first event", profile);
+    cmd.AddValue("scheduler", "Event scheduler (map, list, heap, calendar, priority)", scheduler);
     cmd.Parse(argc, argv);
+    SetSchedulerType(scheduler);
 
     // === 拓扑 ===
     NodeContainer nodes;
@@ -71,7 +92,9 @@ int main(int argc, char* argv[])
     p2p.SetChannelAttribute("Delay", StringValue("2ms"));
     NetDeviceContainer devices = p2p.Install(nodes);
 
+    // 只分配IPv4地址，不安装IPv6协议栈
     InternetStackHelper stack;
+    stack.SetIpv6StackInstall(false);
     stack.Install(nodes);
 
     Ipv4AddressHelper addr;
@@ -101,11 +124,36 @@ int main(int argc, char* argv[])
 
     NS_LOG_INFO("=== Simulation Start ===");
 
-    AsciiTraceHelper ascii;
-    p2p.EnableAsciiAll(ascii.CreateFileStream("task8-p2p.tr"));
-    // p2p.EnablePcapAll("task8-p2p");  // 可选：生成 .pcap
+    std::unique_ptr<BinaryTracer> tracer;
+    if (tracing == "binary")
+    {
+        tracer.reset(new BinaryTracer("task8-p2p.bt"));
+        tracer->Install(devices);
+    }
+    else if (tracing == "ascii")
+    {
+        AsciiTraceHelper ascii;
+        p2p.EnableAsciiAll(ascii.CreateFileStream("task8-p2p.tr"));
+    }
+    else if (tracing == "pcap")
+    {
+        p2p.EnablePcapAll("task8-p2p");
+    }
+    else if (tracing != "none")
+    {
+        NS_FATAL_ERROR("Unknown tracing mode '" << tracing << "' (expected binary, ascii, pcap or none)");
+    }
 
-    Simulator::Run();
+    SimulationProfiler profiler;
+    profiler.Run();
+    if (profile)
+    {
+        profiler.GetProfile().Print(std::cout);
+    }
+    if (tracer)
+    {
+        tracer->Close();
+    }
     Simulator::Destroy();
     NS_LOG_INFO("=== Simulation End ===");
 
@@ -15,130 +15,34 @@
 #include "ns3/flow-monitor-helper.h"
 #include "ns3/ipv4-flow-classifier.h"
 
+#include "../common/adaptive-sweep.h"
+#include "../common/batch-runner.h"
+#include "../common/binary-tracer.h"
+#include "../common/error-model-factory.h"
+#include "../common/flow-aggregator.h"
+#include "../common/flow-stats-sampler.h"
+#include "../common/hot-path-log.h"
+#include "../common/recurring-event.h"
+#include "../common/reliable-header.h"
+#include "../common/replication-stats.h"
+#include "../common/result-writer.h"
+#include "../common/scheduler-type.h"
+#include "../common/simulation-profiler.h"
+
+#include <memory>
+
 using namespace ns3;
 
 NS_LOG_COMPONENT_DEFINE("ReliableTransferSimulation");
 
-// Custom packet header for reliable transfer
-class ReliableHeader : public Header
+// Retransmission strategy shared by ReliableClient and ReliableServer
+enum ArqMode
 {
-public:
-    ReliableHeader();
-    virtual ~ReliableHeader();
-
-    static TypeId GetTypeId(void);
-    virtual TypeId GetInstanceTypeId(void) const;
-    virtual uint32_t GetSerializedSize(void) const;
-    virtual void Serialize(Buffer::Iterator start) const;
-    virtual uint32_t Deserialize(Buffer::Iterator start);
-    virtual void Print(std::ostream &os) const;
-
-    void SetSequenceNumber(uint32_t seq);
-    uint32_t GetSequenceNumber(void) const;
-    void SetAckNumber(uint32_t ack);
-    uint32_t GetAckNumber(void) const;
-    void SetIsAck(bool isAck);
-    bool GetIsAck(void) const;
-
-private:
-    uint32_t m_sequenceNumber;
-    uint32_t m_ackNumber;
-    bool m_isAck;
+    ARQ_STOP_AND_WAIT,
+    ARQ_GO_BACK_N,
+    ARQ_SELECTIVE_REPEAT
 };
 
-ReliableHeader::ReliableHeader()
-    : m_sequenceNumber(0),
-      m_ackNumber(0),
-      m_isAck(false)
-{
-}
-
-ReliableHeader::~ReliableHeader()
-{
-}
-
-TypeId
-ReliableHeader::GetTypeId(void)
-{
-    static TypeId tid = TypeId("ReliableHeader")
-                            .SetParent<Header>()
-                            .SetGroupName("Applications")
-                            .AddConstructor<ReliableHeader>();
-    return tid;
-}
-
-TypeId
-ReliableHeader::GetInstanceTypeId(void) const
-{
-    return GetTypeId();
-}
-
-uint32_t
-ReliableHeader::GetSerializedSize(void) const
-{
-    return sizeof(m_sequenceNumber) + sizeof(m_ackNumber) + sizeof(m_isAck);
-}
-
-void
-ReliableHeader::Serialize(Buffer::Iterator start) const
-{
-    start.WriteHtonU32(m_sequenceNumber);
-    start.WriteHtonU32(m_ackNumber);
-    start.WriteU8(m_isAck ? 1 : 0);
-}
-
-uint32_t
-ReliableHeader::Deserialize(Buffer::Iterator start)
-{
-    m_sequenceNumber = start.ReadNtohU32();
-    m_ackNumber = start.ReadNtohU32();
-    m_isAck = (start.ReadU8() == 1);
-    return GetSerializedSize();
-}
-
-void
-ReliableHeader::Print(std::ostream &os) const
-{
-    os << "Seq: " << m_sequenceNumber << " Ack: " << m_ackNumber 
-       << " IsAck: " << (m_isAck ? "true" : "false");
-}
-
-void
-ReliableHeader::SetSequenceNumber(uint32_t seq)
-{
-    m_sequenceNumber = seq;
-}
-
-uint32_t
-ReliableHeader::GetSequenceNumber(void) const
-{
-    return m_sequenceNumber;
-}
-
-void
-ReliableHeader::SetAckNumber(uint32_t ack)
-{
-    m_ackNumber = ack;
-}
-
-uint32_t
-ReliableHeader::GetAckNumber(void) const
-{
-    return m_ackNumber;
-}
-
-void
-ReliableHeader::SetIsAck(bool isAck)
-{
-    m_isAck = isAck;
-}
-
-bool
-ReliableHeader::GetIsAck(void) const
-{
-    return m_isAck;
-}
-
 // Reliable Server Application
 class ReliableServer : public Application
 {
@@ -147,6 +51,11 @@ public:
     ReliableServer();
     virtual ~ReliableServer();
 
+    uint32_t GetTotalPacketsReceived(void) const;
+    uint32_t GetTotalBytesReceived(void) const;
+    uint32_t GetAcksSent(void) const;
+    Time GetLastDeliveryTime(void) const;
+
 protected:
     virtual void StartApplication(void);
     virtual void StopApplication(void);
@@ -154,10 +63,30 @@ protected:
     void HandleRead(Ptr<Socket> socket);
 
 private:
+    void SendAck(Ptr<Socket> socket, const Address& to, uint32_t seq);
+    void DelayedAckTimeout(void);
+
     Ptr<Socket> m_socket;
+    ArqMode m_mode;
+    uint32_t m_windowSize;
+    
+    // Delayed ACK: in-order packets are acknowledged every m_ackEvery
+    // packets or m_ackDelay after the first unacknowledged one
+    bool m_delayedAck;
+    uint32_t m_ackEvery;
+    Time m_ackDelay;
+    uint32_t m_pendingAcks;
+    uint32_t m_pendingAckSeq;
+    Address m_ackPeer;
+    EventId m_ackEvent;
+    uint32_t m_acksSent;
+    Time m_lastDeliveryTime;
     uint32_t m_expectedSequence;
     uint32_t m_totalPacketsReceived;
     uint32_t m_totalBytesReceived;
+    
+    // Selective repeat: out-of-order packets held in slot seq % window
+    std::vector<bool> m_reorderBuffer;
 };
 
 TypeId
@@ -166,12 +95,46 @@ ReliableServer::GetTypeId(void)
     static TypeId tid = TypeId("ReliableServer")
                             .SetParent<Application>()
                             .SetGroupName("Applications")
-                            .AddConstructor<ReliableServer>();
+                            .AddConstructor<ReliableServer>()
+                            .AddAttribute("Mode",
+                                          "Retransmission strategy; must match the client",
+                                          EnumValue(ARQ_STOP_AND_WAIT),
+                                          MakeEnumAccessor<ArqMode>(&ReliableServer::m_mode),
+                                          MakeEnumChecker(ARQ_STOP_AND_WAIT, "StopAndWait",
+                                                          ARQ_GO_BACK_N, "GoBackN",
+                                                          ARQ_SELECTIVE_REPEAT, "SelectiveRepeat"))
+                            .AddAttribute("WindowSize",
+                                          "Receive window in packets (selective repeat only)",
+                                          UintegerValue(8),
+                                          MakeUintegerAccessor(&ReliableServer::m_windowSize),
+                                          MakeUintegerChecker<uint32_t>(1))
+                            .AddAttribute("DelayedAck",
+                                          "Acknowledge in-order packets in batches instead of one by one",
+                                          BooleanValue(false),
+                                          MakeBooleanAccessor(&ReliableServer::m_delayedAck),
+                                          MakeBooleanChecker())
+                            .AddAttribute("AckEvery",
+                                          "With DelayedAck, send a cumulative ACK after this many in-order packets",
+                                          UintegerValue(2),
+                                          MakeUintegerAccessor(&ReliableServer::m_ackEvery),
+                                          MakeUintegerChecker<uint32_t>(1))
+                            .AddAttribute("AckDelay",
+                                          "With DelayedAck, longest time an in-order packet waits for its ACK",
+                                          TimeValue(MilliSeconds(2)),
+                                          MakeTimeAccessor(&ReliableServer::m_ackDelay),
+                                          MakeTimeChecker());
     return tid;
 }
 
 ReliableServer::ReliableServer()
-    : m_expectedSequence(0),
+    : m_mode(ARQ_STOP_AND_WAIT),
+      m_windowSize(8),
+      m_delayedAck(false),
+      m_ackEvery(2),
+      m_pendingAcks(0),
+      m_pendingAckSeq(0),
+      m_acksSent(0),
+      m_expectedSequence(0),
       m_totalPacketsReceived(0),
       m_totalBytesReceived(0)
 {
@@ -181,6 +144,30 @@ ReliableServer::~ReliableServer()
 {
 }
 
+uint32_t
+ReliableServer::GetTotalPacketsReceived(void) const
+{
+    return m_totalPacketsReceived;
+}
+
+uint32_t
+ReliableServer::GetTotalBytesReceived(void) const
+{
+    return m_totalBytesReceived;
+}
+
+uint32_t
+ReliableServer::GetAcksSent(void) const
+{
+    return m_acksSent;
+}
+
+Time
+ReliableServer::GetLastDeliveryTime(void) const
+{
+    return m_lastDeliveryTime;
+}
+
 void
 ReliableServer::StartApplication(void)
 {
@@ -189,12 +176,15 @@ ReliableServer::StartApplication(void)
     m_socket->Bind(local);
     m_socket->SetRecvCallback(MakeCallback(&ReliableServer::HandleRead, this));
 
+    m_reorderBuffer.assign(m_mode == ARQ_SELECTIVE_REPEAT ? m_windowSize : 0, false);
+
     NS_LOG_INFO("ReliableServer: Started on port 9");
 }
 
 void
 ReliableServer::StopApplication(void)
 {
+    Simulator::Cancel(m_ackEvent);
     if (m_socket)
     {
         m_socket->Close();
@@ -202,6 +192,46 @@ ReliableServer::StopApplication(void)
     
     NS_LOG_INFO("ReliableServer: Total packets received: " << m_totalPacketsReceived);
     NS_LOG_INFO("ReliableServer: Total bytes received: " << m_totalBytesReceived);
+    NS_LOG_INFO("ReliableServer: ACKs sent: " << m_acksSent);
+}
+
+void
+ReliableServer::SendAck(Ptr<Socket> socket, const Address& to, uint32_t seq)
+{
+    ReliableHeader ackHeader;
+    ackHeader.SetIsAck(true);
+    ackHeader.SetSequenceNumber(seq);
+    ackHeader.SetAckNumber(m_expectedSequence);
+
+    uint32_t bitmap = 0;
+    for (uint32_t i = 0; i < ReliableHeader::SACK_BITS && i + 1 < m_reorderBuffer.size(); i++)
+    {
+        if (m_reorderBuffer[(m_expectedSequence + 1 + i) % m_windowSize])
+        {
+            bitmap |= 1u << i;
+        }
+    }
+    ackHeader.SetSackBitmap(bitmap);
+
+    Ptr<Packet> ackPacket = Create<Packet>(0);
+    ackPacket->AddHeader(ackHeader);
+    socket->SendTo(ackPacket, 0, to);
+    m_acksSent++;
+
+    // This ACK is cumulative, so it also covers any batch being delayed
+    m_pendingAcks = 0;
+    Simulator::Cancel(m_ackEvent);
+
+    HOT_PATH_LOG_INFO("ReliableServer: Sent ACK " << m_expectedSequence << " for seq=" << seq);
+}
+
+void
+ReliableServer::DelayedAckTimeout(void)
+{
+    if (m_pendingAcks > 0)
+    {
+        SendAck(m_socket, m_ackPeer, m_pendingAckSeq);
+    }
 }
 
 void
@@ -223,31 +253,54 @@ ReliableServer::HandleRead(Ptr<Socket> socket)
         {
             uint32_t seq = header.GetSequenceNumber();
             
-            NS_LOG_INFO("ReliableServer: Received data packet with seq=" << seq 
-                       << ", expected=" << m_expectedSequence);
+            HOT_PATH_LOG_INFO("ReliableServer: Received data packet with seq=" << seq 
+                             << ", expected=" << m_expectedSequence);
             
             // Check if this is the expected sequence number
             if (seq == m_expectedSequence)
             {
                 m_totalPacketsReceived++;
                 m_expectedSequence++;
-                
-                // Send ACK for this sequence number
-                Ptr<Packet> ackPacket = Create<Packet>(0);
-                ReliableHeader ackHeader;
-                ackHeader.SetIsAck(true);
-                ackHeader.SetAckNumber(seq);
-                
-                ackPacket->AddHeader(ackHeader);
-                socket->SendTo(ackPacket, 0, from);
-                
-                NS_LOG_INFO("ReliableServer: Sent ACK for seq=" << seq);
+
+                // Deliver whatever this packet unblocks from the reorder buffer
+                bool filledGap = false;
+                while (!m_reorderBuffer.empty() && m_reorderBuffer[m_expectedSequence % m_windowSize])
+                {
+                    m_reorderBuffer[m_expectedSequence % m_windowSize] = false;
+                    m_totalPacketsReceived++;
+                    m_expectedSequence++;
+                    filledGap = true;
+                }
+                m_lastDeliveryTime = Simulator::Now();
+
+                // In-order arrivals may wait for a batched ACK; filling a
+                // gap is reported at once so the sender stops retransmitting
+                if (m_delayedAck && !filledGap && ++m_pendingAcks < m_ackEvery)
+                {
+                    m_pendingAckSeq = seq;
+                    m_ackPeer = from;
+                    if (!m_ackEvent.IsPending())
+                    {
+                        m_ackEvent = Simulator::Schedule(m_ackDelay, &ReliableServer::DelayedAckTimeout, this);
+                    }
+                    continue;
+                }
+            }
+            else if (!m_reorderBuffer.empty() && seq > m_expectedSequence &&
+                     seq < m_expectedSequence + m_windowSize)
+            {
+                m_reorderBuffer[seq % m_windowSize] = true;
+                NS_LOG_INFO("ReliableServer: Buffered out-of-order seq=" << seq);
             }
             else
             {
                 NS_LOG_INFO("ReliableServer: Unexpected sequence number, expected=" 
                            << m_expectedSequence << ", received=" << seq);
             }
+
+            // All other data packets are acknowledged at once, duplicates
+            // included: a retransmission usually means our ACK was lost
+            SendAck(socket, from, seq);
         }
     }
 }
@@ -263,13 +316,41 @@ public:
     void SetRemote(Address ip, uint16_t port);
     void SetRemote(Address addr);
 
+    uint32_t GetTotalPacketsSent(void) const;
+    uint32_t GetRetransmissions(void) const;
+    uint32_t GetTotalBytesSent(void) const;
+    double GetEffectiveThroughput(void) const;
+    uint32_t GetPacketsAcked(void) const;
+    uint64_t GetBytesAllocated(void) const;
+    double GetBytesAllocatedPerDelivered(void) const;
+    uint32_t GetTimeouts(void) const;
+    uint32_t GetTimerSchedules(void) const;
+    Time GetSmoothedRtt(void) const;
+    Time GetRto(void) const;
+
 protected:
     virtual void StartApplication(void);
     virtual void StopApplication(void);
 
     void SendPacket(void);
     void HandleRead(Ptr<Socket> socket);
-    void TimeoutHandler(uint32_t seq);
+    void TimeoutHandler(void);
+
+private:
+    // Send-buffer entry for one in-flight sequence number
+    struct SendSlot
+    {
+        bool acked;
+        bool retransmitted; // Karn's rule: no RTT sample from this packet
+        Time sentAt;
+    };
+
+    Ptr<Packet> MakeDataPacket(uint32_t seq);
+    void Transmit(uint32_t seq);
+    void ScheduleNextSend(void);
+    void MarkAcked(uint32_t seq);
+    void ArmRetransmitTimer(Time deadline);
+    void UpdateRto(Time rtt);
 
 private:
     Ptr<Socket> m_socket;
@@ -277,19 +358,45 @@ private:
     uint16_t m_peerPort;
     
     uint32_t m_sequenceNumber;
+    uint32_t m_base;
     uint32_t m_nextSequence;
     uint32_t m_totalPacketsSent;
     uint32_t m_retransmissions;
     uint32_t m_totalBytesSent;
     
+    // One retransmission timer per connection. m_rtoDeadline is when the
+    // oldest unacked packet expires; the event may fire earlier and re-arm
+    // itself, so moving the deadline later never touches the event queue.
+    // Both timers reuse their event objects (see recurring-event.h).
     EventId m_timerEvent;
+    RecurringEvent<ReliableClient> m_timerEvents;
+    Time m_rtoDeadline;
+    uint32_t m_timerSchedules;
+    uint32_t m_timeouts;
+    EventId m_sendEvent;
+    RecurringEvent<ReliableClient> m_sendEvents;
+    Time m_lastSendTime;
     Time m_timeout;
+    bool m_adaptiveRto;
+    Time m_minRto;
+    Time m_maxRto;
+    Time m_rto;
+    Time m_srtt;
+    Time m_rttvar;
+    bool m_haveRttSample;
     uint32_t m_maxPackets;
     Time m_interval;
     uint32_t m_packetSize;
+    ArqMode m_mode;
+    uint32_t m_windowSize;
     
-    bool m_waitingForAck;
-    uint32_t m_pendingAckSequence;
+    // Circular send buffer: sequence seq lives in slot seq % window
+    std::vector<SendSlot> m_sendBuffer;
+    uint32_t m_packetsAcked;
+    
+    // Header-less payload per payload size; data packets are copies of it
+    std::map<uint32_t, Ptr<Packet>> m_packetTemplates;
+    uint64_t m_bytesAllocated;
     
     Time m_startTime;
     Time m_endTime;
@@ -318,21 +425,57 @@ ReliableClient::GetTypeId(void)
                                           MakeUintegerAccessor(&ReliableClient::m_packetSize),
                                           MakeUintegerChecker<uint32_t>())
                             .AddAttribute("Timeout",
-                                          "Timeout for ACK reception",
+                                          "Initial retransmission timeout (the fixed one if AdaptiveRto is false)",
                                           TimeValue(Seconds(0.5)),
                                           MakeTimeAccessor(&ReliableClient::m_timeout),
-                                          MakeTimeChecker());
+                                          MakeTimeChecker())
+                            .AddAttribute("AdaptiveRto",
+                                          "Derive the timeout from measured RTTs (RFC 6298) with exponential backoff",
+                                          BooleanValue(true),
+                                          MakeBooleanAccessor(&ReliableClient::m_adaptiveRto),
+                                          MakeBooleanChecker())
+                            .AddAttribute("MinRto",
+                                          "Lower bound of the adaptive retransmission timeout",
+                                          TimeValue(MilliSeconds(10)),
+                                          MakeTimeAccessor(&ReliableClient::m_minRto),
+                                          MakeTimeChecker())
+                            .AddAttribute("MaxRto",
+                                          "Upper bound of the adaptive retransmission timeout",
+                                          TimeValue(Seconds(60)),
+                                          MakeTimeAccessor(&ReliableClient::m_maxRto),
+                                          MakeTimeChecker())
+                            .AddAttribute("Mode",
+                                          "Retransmission strategy",
+                                          EnumValue(ARQ_STOP_AND_WAIT),
+                                          MakeEnumAccessor<ArqMode>(&ReliableClient::m_mode),
+                                          MakeEnumChecker(ARQ_STOP_AND_WAIT, "StopAndWait",
+                                                          ARQ_GO_BACK_N, "GoBackN",
+                                                          ARQ_SELECTIVE_REPEAT, "SelectiveRepeat"))
+                            .AddAttribute("WindowSize",
+                                          "Packets in flight for GoBackN and SelectiveRepeat",
+                                          UintegerValue(8),
+                                          MakeUintegerAccessor(&ReliableClient::m_windowSize),
+                                          MakeUintegerChecker<uint32_t>(1));
     return tid;
 }
 
 ReliableClient::ReliableClient()
     : m_sequenceNumber(0),
+      m_base(0),
       m_nextSequence(0),
       m_totalPacketsSent(0),
       m_retransmissions(0),
       m_totalBytesSent(0),
-      m_waitingForAck(false),
-      m_pendingAckSequence(0)
+      m_timerEvents(this, &ReliableClient::TimeoutHandler),
+      m_timerSchedules(0),
+      m_timeouts(0),
+      m_sendEvents(this, &ReliableClient::SendPacket),
+      m_adaptiveRto(true),
+      m_haveRttSample(false),
+      m_mode(ARQ_STOP_AND_WAIT),
+      m_windowSize(8),
+      m_packetsAcked(0),
+      m_bytesAllocated(0)
 {
 }
 
@@ -353,6 +496,105 @@ ReliableClient::SetRemote(Address addr)
     m_peerAddress = addr;
 }
 
+uint32_t
+ReliableClient::GetTotalPacketsSent(void) const
+{
+    return m_totalPacketsSent;
+}
+
+uint32_t
+ReliableClient::GetRetransmissions(void) const
+{
+    return m_retransmissions;
+}
+
+uint32_t
+ReliableClient::GetTotalBytesSent(void) const
+{
+    return m_totalBytesSent;
+}
+
+double
+ReliableClient::GetEffectiveThroughput(void) const
+{
+    // The simulation may end before StopApplication runs
+    Time endTime = m_endTime.IsZero() ? Simulator::Now() : m_endTime;
+    Time totalTime = endTime - m_startTime;
+    if (totalTime.GetSeconds() <= 0)
+    {
+        return 0.0;
+    }
+    return (m_totalBytesSent * 8.0) / totalTime.GetSeconds() / 1000000.0; // Mbps
+}
+
+uint32_t
+ReliableClient::GetPacketsAcked(void) const
+{
+    return m_packetsAcked;
+}
+
+uint64_t
+ReliableClient::GetBytesAllocated(void) const
+{
+    return m_bytesAllocated;
+}
+
+double
+ReliableClient::GetBytesAllocatedPerDelivered(void) const
+{
+    if (m_packetsAcked == 0)
+    {
+        return 0.0;
+    }
+    return static_cast<double>(m_bytesAllocated) / m_packetsAcked;
+}
+
+uint32_t
+ReliableClient::GetTimeouts(void) const
+{
+    return m_timeouts;
+}
+
+uint32_t
+ReliableClient::GetTimerSchedules(void) const
+{
+    return m_timerSchedules;
+}
+
+Time
+ReliableClient::GetSmoothedRtt(void) const
+{
+    return m_srtt;
+}
+
+Time
+ReliableClient::GetRto(void) const
+{
+    return m_rto;
+}
+
+Ptr<Packet>
+ReliableClient::MakeDataPacket(uint32_t seq)
+{
+    // The payload is built once per size; Copy() shares its buffer, so each
+    // transmission only serializes the header in front of it
+    Ptr<Packet>& packetTemplate = m_packetTemplates[m_packetSize];
+    if (!packetTemplate)
+    {
+        packetTemplate = Create<Packet>(m_packetSize);
+        m_bytesAllocated += m_packetSize;
+    }
+
+    ReliableHeader header;
+    header.SetSequenceNumber(seq);
+    header.SetIsAck(false);
+
+    Ptr<Packet> packet = packetTemplate->Copy();
+    packet->AddHeader(header);
+    m_bytesAllocated += header.GetSerializedSize();
+    return packet;
+}
+
 void
 ReliableClient::StartApplication(void)
 {
@@ -361,9 +603,15 @@ ReliableClient::StartApplication(void)
     m_socket->SetRecvCallback(MakeCallback(&ReliableClient::HandleRead, this));
     
     m_startTime = Simulator::Now();
+    if (m_mode == ARQ_STOP_AND_WAIT)
+    {
+        m_windowSize = 1;
+    }
+    m_sendBuffer.assign(m_windowSize, SendSlot{false, false, Time()});
+    m_rto = m_timeout;
     
     // Schedule first packet transmission
-    Simulator::Schedule(Seconds(0.1), &ReliableClient::SendPacket, this);
+    m_sendEvent = m_sendEvents.Schedule(Seconds(0.1));
     
     NS_LOG_INFO("ReliableClient: Started, will send " << m_maxPackets << " packets");
 }
@@ -371,20 +619,14 @@ ReliableClient::StartApplication(void)
 void
 ReliableClient::StopApplication(void)
 {
-    if (m_timerEvent.IsPending())
-    {
-        Simulator::Cancel(m_timerEvent);
-    }
+    Simulator::Cancel(m_timerEvent);
+    Simulator::Cancel(m_sendEvent);
     
     m_endTime = Simulator::Now();
     Time totalTime = m_endTime - m_startTime;
     
     // Calculate effective throughput
-    double effectiveThroughput = 0.0;
-    if (totalTime.GetSeconds() > 0)
-    {
-        effectiveThroughput = (m_totalBytesSent * 8.0) / totalTime.GetSeconds() / 1000000.0; // Mbps
-    }
+    double effectiveThroughput = GetEffectiveThroughput();
     
     NS_LOG_INFO("=== RELIABLE CLIENT STATISTICS ===");
     NS_LOG_INFO("Total packets sent: " << m_totalPacketsSent);
@@ -393,39 +635,117 @@ ReliableClient::StopApplication(void)
     NS_LOG_INFO("Total time: " << totalTime.GetSeconds() << " seconds");
     NS_LOG_INFO("Effective throughput: " << effectiveThroughput << " Mbps");
     NS_LOG_INFO("Packet loss rate: " << (m_retransmissions * 100.0 / m_totalPacketsSent) << "%");
+    NS_LOG_INFO("Bytes allocated per delivered packet: " << GetBytesAllocatedPerDelivered());
+    NS_LOG_INFO("Timeouts: " << m_timeouts << ", timer events scheduled: " << m_timerSchedules);
+    NS_LOG_INFO("Smoothed RTT: " << m_srtt.GetMilliSeconds() << " ms, final RTO: "
+                << m_rto.GetMilliSeconds() << " ms");
 }
 
 void
-ReliableClient::SendPacket(void)
+ReliableClient::ArmRetransmitTimer(Time deadline)
 {
-    if (m_nextSequence >= m_maxPackets)
+    m_rtoDeadline = deadline;
+    if (m_timerEvent.IsPending() &&
+        Simulator::Now() + Simulator::GetDelayLeft(m_timerEvent) <= deadline)
     {
-        NS_LOG_INFO("ReliableClient: Finished sending all packets");
+        // The pending event fires first and re-arms itself for the new deadline
         return;
     }
-    
-    // Create packet with data
-    Ptr<Packet> packet = Create<Packet>(m_packetSize);
-    ReliableHeader header;
-    header.SetSequenceNumber(m_nextSequence);
-    header.SetIsAck(false);
-    
-    packet->AddHeader(header);
-    
-    // Send packet
+    Simulator::Cancel(m_timerEvent);
+    m_timerEvent = m_timerEvents.Schedule(deadline - Simulator::Now());
+    m_timerSchedules++;
+}
+
+void
+ReliableClient::UpdateRto(Time rtt)
+{
+    // RFC 6298, section 2 (clock granularity is negligible in simulation)
+    if (!m_haveRttSample)
+    {
+        m_srtt = rtt;
+        m_rttvar = rtt / 2;
+        m_haveRttSample = true;
+    }
+    else
+    {
+        Time error = m_srtt > rtt ? m_srtt - rtt : rtt - m_srtt;
+        m_rttvar = (3 * m_rttvar + error) / 4;
+        m_srtt = (7 * m_srtt + rtt) / 8;
+    }
+    m_rto = std::min(std::max(m_srtt + 4 * m_rttvar, m_minRto), m_maxRto);
+}
+
+void
+ReliableClient::Transmit(uint32_t seq)
+{
+    Ptr<Packet> packet = MakeDataPacket(seq);
     m_socket->SendTo(packet, 0, m_peerAddress);
     
     m_totalPacketsSent++;
     m_totalBytesSent += packet->GetSize();
     
-    NS_LOG_INFO("ReliableClient: Sent packet with seq=" << m_nextSequence);
+    SendSlot& slot = m_sendBuffer[seq % m_windowSize];
+    slot.retransmitted = slot.retransmitted || !slot.sentAt.IsZero();
+    slot.sentAt = Simulator::Now();
     
-    // Set up timer for ACK
-    m_waitingForAck = true;
-    m_pendingAckSequence = m_nextSequence;
-    m_timerEvent = Simulator::Schedule(m_timeout, &ReliableClient::TimeoutHandler, this, m_nextSequence);
+    if (m_rtoDeadline.IsZero())
+    {
+        // Nothing was outstanding: start the clock for this packet
+        ArmRetransmitTimer(Simulator::Now() + m_rto);
+    }
+}
+
+void
+ReliableClient::ScheduleNextSend(void)
+{
+    if (m_sendEvent.IsPending() || m_nextSequence >= m_maxPackets ||
+        m_nextSequence >= m_base + m_windowSize)
+    {
+        return;
+    }
     
+    // Stop-and-wait waits Interval after the ACK; the windowed modes keep
+    // new transmissions at least Interval apart and otherwise send at once
+    Time delay = m_interval;
+    if (m_mode != ARQ_STOP_AND_WAIT)
+    {
+        delay = std::max(Seconds(0), m_lastSendTime + m_interval - Simulator::Now());
+    }
+    m_sendEvent = m_sendEvents.Schedule(delay);
+}
+
+void
+ReliableClient::SendPacket(void)
+{
+    if (m_nextSequence >= m_maxPackets)
+    {
+        NS_LOG_INFO("ReliableClient: Finished sending all packets");
+        return;
+    }
+    if (m_nextSequence >= m_base + m_windowSize)
+    {
+        // Window full; the next ACK reopens it
+        return;
+    }
+    
+    Transmit(m_nextSequence);
+    
+    HOT_PATH_LOG_INFO("ReliableClient: Sent packet with seq=" << m_nextSequence);
+    
+    m_lastSendTime = Simulator::Now();
     m_nextSequence++;
+    ScheduleNextSend();
+}
+
+void
+ReliableClient::MarkAcked(uint32_t seq)
+{
+    SendSlot& slot = m_sendBuffer[seq % m_windowSize];
+    if (!slot.acked)
+    {
+        slot.acked = true;
+        m_packetsAcked++;
+    }
 }
 
 void
@@ -439,77 +759,223 @@ ReliableClient::HandleRead(Ptr<Socket> socket)
         ReliableHeader header;
         packet->RemoveHeader(header);
         
-        if (header.GetIsAck())
+        if (!header.GetIsAck())
+        {
+            continue;
+        }
+        
+        uint32_t ackNumber = header.GetAckNumber();
+        HOT_PATH_LOG_INFO("ReliableClient: Received ACK " << ackNumber << " for seq="
+                          << header.GetSequenceNumber());
+        
+        if (ackNumber > m_nextSequence)
         {
-            uint32_t ackSeq = header.GetAckNumber();
-            NS_LOG_INFO("ReliableClient: Received ACK for seq=" << ackSeq);
-            
-            if (m_waitingForAck && ackSeq == m_pendingAckSequence)
+            continue;
+        }
+        
+        // RTT sample from the data packet that triggered this ACK
+        uint32_t echoed = header.GetSequenceNumber();
+        if (m_adaptiveRto && echoed >= m_base && echoed < m_nextSequence)
+        {
+            const SendSlot& slot = m_sendBuffer[echoed % m_windowSize];
+            if (!slot.acked && !slot.retransmitted)
+            {
+                UpdateRto(Simulator::Now() - slot.sentAt);
+            }
+        }
+        
+        // Selectively acknowledged packets above the cumulative point
+        if (m_mode == ARQ_SELECTIVE_REPEAT)
+        {
+            uint32_t bitmap = header.GetSackBitmap();
+            for (uint32_t i = 0; i < ReliableHeader::SACK_BITS; i++)
             {
-                // Cancel timeout timer
-                if (m_timerEvent.IsPending())
+                uint32_t seq = ackNumber + 1 + i;
+                if ((bitmap & (1u << i)) && seq >= m_base && seq < m_nextSequence)
                 {
-                    Simulator::Cancel(m_timerEvent);
+                    MarkAcked(seq);
                 }
-                
-                m_waitingForAck = false;
-                
-                // Schedule next packet
-                Simulator::Schedule(m_interval, &ReliableClient::SendPacket, this);
             }
         }
+        
+        if (ackNumber <= m_base)
+        {
+            continue;
+        }
+        
+        // Cumulative ACK: slide the window and free the slots for reuse
+        for (uint32_t seq = m_base; seq < ackNumber; seq++)
+        {
+            MarkAcked(seq);
+            m_sendBuffer[seq % m_windowSize] = SendSlot{false, false, Time()};
+        }
+        m_base = ackNumber;
+        
+        // Restart the clock for the remaining packets (RFC 6298, 5.3), or
+        // leave the pending event to expire harmlessly if none are left
+        m_rtoDeadline = m_base < m_nextSequence ? Simulator::Now() + m_rto : Time();
+        if (!m_rtoDeadline.IsZero())
+        {
+            ArmRetransmitTimer(m_rtoDeadline);
+        }
+        
+        if (m_base >= m_maxPackets)
+        {
+            NS_LOG_INFO("ReliableClient: All packets acknowledged");
+        }
+        
+        // Schedule next packet
+        ScheduleNextSend();
     }
 }
 
 void
-ReliableClient::TimeoutHandler(uint32_t seq)
+ReliableClient::TimeoutHandler(void)
 {
-    if (m_waitingForAck && seq == m_pendingAckSequence)
+    if (m_rtoDeadline.IsZero() || m_base >= m_nextSequence)
     {
-        NS_LOG_INFO("ReliableClient: Timeout for seq=" << seq << ", retransmitting");
-        
-        m_retransmissions++;
-        
-        // Resend the packet
-        Ptr<Packet> packet = Create<Packet>(m_packetSize);
-        ReliableHeader header;
-        header.SetSequenceNumber(seq);
-        header.SetIsAck(false);
-        
-        packet->AddHeader(header);
-        m_socket->SendTo(packet, 0, m_peerAddress);
-        
-        m_totalPacketsSent++;
-        m_totalBytesSent += packet->GetSize();
-        
-        // Reset timer
-        m_timerEvent = Simulator::Schedule(m_timeout, &ReliableClient::TimeoutHandler, this, seq);
+        return;
     }
+    if (Simulator::Now() < m_rtoDeadline)
+    {
+        // The deadline moved since this event was scheduled
+        m_timerEvent = m_timerEvents.Schedule(m_rtoDeadline - Simulator::Now());
+        m_timerSchedules++;
+        return;
+    }
+    
+    m_timeouts++;
+    Time expiredRto = m_rto;
+    if (m_adaptiveRto)
+    {
+        m_rto = std::min(2 * m_rto, m_maxRto);
+    }
+    
+    if (m_mode == ARQ_SELECTIVE_REPEAT)
+    {
+        // Resend the unacked packets whose own timeout has run out; the
+        // oldest one always has, since the deadline is tracked for it
+        NS_LOG_INFO("ReliableClient: Timeout at base=" << m_base << ", retransmitting expired packets");
+        for (uint32_t seq = m_base; seq < m_nextSequence; seq++)
+        {
+            const SendSlot& slot = m_sendBuffer[seq % m_windowSize];
+            if (!slot.acked && (seq == m_base || slot.sentAt + expiredRto <= Simulator::Now()))
+            {
+                m_retransmissions++;
+                Transmit(seq);
+            }
+        }
+    }
+    else
+    {
+        // Stop-and-wait and go-back-N resend everything from the oldest unacked packet
+        NS_LOG_INFO("ReliableClient: Timeout for seq=" << m_base << ", retransmitting "
+                    << (m_nextSequence - m_base) << " packet(s)");
+        for (uint32_t resend = m_base; resend < m_nextSequence; resend++)
+        {
+            m_retransmissions++;
+            Transmit(resend);
+        }
+    }
+    
+    ArmRetransmitTimer(Simulator::Now() + m_rto);
 }
 
-int
-main(int argc, char* argv[])
+// Parameters of one simulation run
+struct ExperimentConfig
 {
-    bool verbose = true;
+    bool verbose = false;
     bool tracing = false;
+    std::string traceFormat = "binary";
     double errorRate = 0.1;  // 10% packet error rate by default
+    std::string errorModel = "rate";
+    std::string burstParams;
+    bool perDeviceErrorModel = true;
     uint32_t maxPackets = 50;
     double simulationTime = 30.0;
     uint32_t packetSize = 1024;
     double interval = 1.0;
     double timeout = 0.5;
+    bool adaptiveRto = true;
+    double minRto = 0.01;
+    std::string mode = "StopAndWait";
+    uint32_t windowSize = 8;
+    bool delayedAck = false;
+    uint32_t ackEvery = 2;
+    double ackDelay = 0.002;
+    uint32_t runs = 1;
+    uint32_t minRuns = 3;
+    double ciTarget = 0.05;
+    std::string flowSamples;
+    std::string flowSampleFormat = "bin";
+    double flowSampleInterval = 0.1;
+    std::string resultFormat = "text";
+    std::string resultFile;
+    std::string batchFile;
+    std::string scheduler = "map";
+};
 
-    CommandLine cmd(__FILE__);
-    cmd.AddValue("verbose", "Tell echo applications to log if true", verbose);
-    cmd.AddValue("tracing", "Enable pcap tracing", tracing);
-    cmd.AddValue("errorRate", "Packet error rate on the channel", errorRate);
-    cmd.AddValue("maxPackets", "Maximum number of packets to send", maxPackets);
-    cmd.AddValue("simulationTime", "Simulation time in seconds", simulationTime);
-    cmd.AddValue("packetSize", "Packet size in bytes", packetSize);
-    cmd.AddValue("interval", "Interval between packets in seconds", interval);
-    cmd.AddValue("timeout", "Timeout for ACK in seconds", timeout);
+// First random stream of the link error models. Fixing it keeps each
+// direction's loss pattern a function of RngRun alone.
+const int64_t ERROR_MODEL_STREAM = 0;
 
-    cmd.Parse(argc, argv);
+// Metrics whose confidence interval decides when replications may stop
+const std::vector<std::string> CI_METRICS = {"goodput", "effectiveThroughput"};
+
+// Register the command-line options; batch mode re-parses them for every line
+void
+AddCommandLineOptions(CommandLine& cmd, ExperimentConfig& config)
+{
+    cmd.AddValue("verbose", "Tell echo applications to log if true", config.verbose);
+    cmd.AddValue("tracing", "Enable packet tracing", config.tracing);
+    cmd.AddValue("traceFormat", "Trace format with --tracing (binary: reliable_transfer.bt, pcap)", config.traceFormat);
+    cmd.AddValue("errorRate", "Packet error rate on the channel", config.errorRate);
+    cmd.AddValue("errorModel", "Error model (rate: independent, burst: BurstErrorModel, gilbert: Gilbert-Elliott)", config.errorModel);
+    cmd.AddValue("burstParams", "Error model parameters, e.g. minBurst=1,maxBurst=4 or pBadGood=0.25,lossBad=1", config.burstParams);
+    cmd.AddValue("perDeviceErrorModel", "Give each device its own error model (false: both directions share one)", config.perDeviceErrorModel);
+    cmd.AddValue("maxPackets", "Maximum number of packets to send", config.maxPackets);
+    cmd.AddValue("simulationTime", "Simulation time in seconds", config.simulationTime);
+    cmd.AddValue("packetSize", "Packet size in bytes", config.packetSize);
+    cmd.AddValue("interval", "Interval between packets in seconds", config.interval);
+    cmd.AddValue("timeout", "Initial ACK timeout in seconds (fixed if adaptiveRto is false)", config.timeout);
+    cmd.AddValue("adaptiveRto", "Adapt the ACK timeout to the measured RTT with backoff", config.adaptiveRto);
+    cmd.AddValue("minRto", "Lower bound of the adaptive ACK timeout in seconds", config.minRto);
+    cmd.AddValue("mode", "Retransmission strategy (StopAndWait, GoBackN, SelectiveRepeat)", config.mode);
+    cmd.AddValue("windowSize", "Send/receive window in packets for GoBackN and SelectiveRepeat", config.windowSize);
+    cmd.AddValue("delayedAck", "Batch the server's ACKs for in-order packets", config.delayedAck);
+    cmd.AddValue("ackEvery", "With delayedAck, ACK after this many in-order packets", config.ackEvery);
+    cmd.AddValue("ackDelay", "With delayedAck, longest ACK delay in seconds", config.ackDelay);
+    cmd.AddValue("runs", "Maximum number of independent replications (RngRun, RngRun+1, ...)", config.runs);
+    cmd.AddValue("minRuns", "Replications to run before stopping early is considered", config.minRuns);
+    cmd.AddValue("ciTarget", "Stop once the 95% CI half-width of goodput and throughput is below this fraction of the mean", config.ciTarget);
+    cmd.AddValue("flowSamples", "Stream per-flow FlowMonitor deltas to this file (suffixed .<run> with several runs)", config.flowSamples);
+    cmd.AddValue("flowSampleFormat", "Flow sample format (csv, jsonl, bin)", config.flowSampleFormat);
+    cmd.AddValue("flowSampleInterval", "Flow sample interval in seconds", config.flowSampleInterval);
+    cmd.AddValue("resultFormat", "Result output format (text, csv, jsonl, bin)", config.resultFormat);
+    cmd.AddValue("resultFile", "Result output file for csv/jsonl/bin (default: stdout)", config.resultFile);
+    cmd.AddValue("batch", "Batch file: run one configuration per line in this process", config.batchFile);
+    cmd.AddValue("scheduler", "Event scheduler (map, list, heap, calendar, priority)", config.scheduler);
+}
+
+// Schema version of the result records; bump it when a field's meaning or order changes
+const uint32_t RESULT_SCHEMA_VERSION = 9;
+
+// Build, run and report one simulation; returns its result record
+ResultRecord
+RunExperiment(const ExperimentConfig& config, ResultWriter& writer)
+{
+    bool verbose = config.verbose;
+    bool tracing = config.tracing;
+    double errorRate = config.errorRate;
+    uint32_t maxPackets = config.maxPackets;
+    double simulationTime = config.simulationTime;
+    uint32_t packetSize = config.packetSize;
+    double interval = config.interval;
+    double timeout = config.timeout;
+    uint32_t windowSize = config.mode == "StopAndWait" ? 1 : config.windowSize;
+    bool textOutput = !writer.IsEnabled();
+    ErrorModelFactory errorModels(config.errorModel, errorRate, config.burstParams);
+    SetSchedulerType(config.scheduler);
 
     if (verbose)
     {
@@ -529,14 +995,11 @@ main(int argc, char* argv[])
     devices = pointToPoint.Install(nodes);
 
     // Add error model to the devices
-    Ptr<RateErrorModel> em = CreateObject<RateErrorModel>();
-    em->SetAttribute("ErrorRate", DoubleValue(errorRate));
-    em->SetAttribute("ErrorUnit", StringValue("ERROR_UNIT_PACKET"));
-    devices.Get(0)->SetAttribute("ReceiveErrorModel", PointerValue(em));
-    devices.Get(1)->SetAttribute("ReceiveErrorModel", PointerValue(em));
+    errorModels.Install(devices, config.perDeviceErrorModel, ERROR_MODEL_STREAM);
 
-    // Install internet stack
+    // Install internet stack (IPv4 only; IPv6 is never used)
     InternetStackHelper stack;
+    stack.SetIpv6StackInstall(false);
     stack.Install(nodes);
 
     // Assign IP addresses
@@ -546,6 +1009,11 @@ main(int argc, char* argv[])
 
     // Install reliable server on node 1
     Ptr<ReliableServer> serverApp = CreateObject<ReliableServer>();
+    serverApp->SetAttribute("Mode", StringValue(config.mode));
+    serverApp->SetAttribute("WindowSize", UintegerValue(windowSize));
+    serverApp->SetAttribute("DelayedAck", BooleanValue(config.delayedAck));
+    serverApp->SetAttribute("AckEvery", UintegerValue(config.ackEvery));
+    serverApp->SetAttribute("AckDelay", TimeValue(Seconds(config.ackDelay)));
     nodes.Get(1)->AddApplication(serverApp);
     serverApp->SetStartTime(Seconds(1.0));
     serverApp->SetStopTime(Seconds(simulationTime));
@@ -557,6 +1025,10 @@ main(int argc, char* argv[])
     clientApp->SetAttribute("PacketSize", UintegerValue(packetSize));
     clientApp->SetAttribute("Interval", TimeValue(Seconds(interval)));
     clientApp->SetAttribute("Timeout", TimeValue(Seconds(timeout)));
+    clientApp->SetAttribute("AdaptiveRto", BooleanValue(config.adaptiveRto));
+    clientApp->SetAttribute("MinRto", TimeValue(Seconds(config.minRto)));
+    clientApp->SetAttribute("Mode", StringValue(config.mode));
+    clientApp->SetAttribute("WindowSize", UintegerValue(windowSize));
     nodes.Get(0)->AddApplication(clientApp);
     clientApp->SetStartTime(Seconds(2.0));
     clientApp->SetStopTime(Seconds(simulationTime));
@@ -578,65 +1050,251 @@ main(int argc, char* argv[])
     // Install FlowMonitor for performance analysis
     FlowMonitorHelper flowHelper;
     Ptr<FlowMonitor> flowMonitor = flowHelper.InstallAll();
+    Ptr<Ipv4FlowClassifier> classifier = DynamicCast<Ipv4FlowClassifier>(flowHelper.GetClassifier());
+    std::unique_ptr<FlowStatsSampler> sampler;
+    if (!config.flowSamples.empty())
+    {
+        std::string filename = config.flowSamples;
+        if (config.runs > 1)
+        {
+            filename += "." + std::to_string(RngSeedManager::GetRun());
+        }
+        sampler.reset(new FlowStatsSampler(flowMonitor, classifier, config.flowSampleFormat, filename,
+                                           Seconds(config.flowSampleInterval)));
+        sampler->Start(Seconds(0));
+    }
 
     // Set up routing
     Ipv4GlobalRoutingHelper::PopulateRoutingTables();
 
-    if (tracing)
+    // The binary tracer is cheap enough to leave on in sweeps; convert its
+    // output with exp1's binary-trace-convert
+    std::unique_ptr<BinaryTracer> tracer;
+    if (tracing && config.traceFormat == "binary")
+    {
+        std::string filename = "reliable_transfer.bt";
+        if (config.runs > 1)
+        {
+            filename += "." + std::to_string(RngSeedManager::GetRun());
+        }
+        tracer.reset(new BinaryTracer(filename));
+        tracer->Install(devices);
+    }
+    else if (tracing && config.traceFormat == "pcap")
     {
         pointToPoint.EnablePcapAll("reliable_transfer");
     }
+    else if (tracing)
+    {
+        NS_FATAL_ERROR("Unknown trace format '" << config.traceFormat << "' (expected binary or pcap)");
+    }
 
     // Set simulation stop time
     Simulator::Stop(Seconds(simulationTime));
 
-    std::cout << "Starting simulation with parameters:" << std::endl;
-    std::cout << "  Error rate: " << errorRate * 100 << "%" << std::endl;
-    std::cout << "  Max packets: " << maxPackets << std::endl;
-    std::cout << "  Packet size: " << packetSize << " bytes" << std::endl;
-    std::cout << "  Interval: " << interval << " seconds" << std::endl;
-    std::cout << "  Timeout: " << timeout << " seconds" << std::endl;
-    std::cout << "  Simulation time: " << simulationTime << " seconds" << std::endl;
+    if (textOutput)
+    {
+        std::cout << "Starting simulation with parameters:" << std::endl;
+        std::cout << "  Error rate: " << errorRate * 100 << "%" << std::endl;
+        if (config.errorModel != "rate")
+        {
+            std::cout << "  Error model: " << config.errorModel;
+            if (!config.burstParams.empty())
+            {
+                std::cout << " (" << config.burstParams << ")";
+            }
+            std::cout << std::endl;
+        }
+        std::cout << "  Max packets: " << maxPackets << std::endl;
+        std::cout << "  Packet size: " << packetSize << " bytes" << std::endl;
+        std::cout << "  Interval: " << interval << " seconds" << std::endl;
+        std::cout << "  Timeout: " << timeout << " seconds"
+                  << (config.adaptiveRto ? " (initial, adaptive)" : "") << std::endl;
+        std::cout << "  Mode: " << config.mode << " (window " << windowSize << ")" << std::endl;
+        if (config.delayedAck)
+        {
+            std::cout << "  Delayed ACK: every " << config.ackEvery << " packets or "
+                      << config.ackDelay << " seconds" << std::endl;
+        }
+        std::cout << "  Simulation time: " << simulationTime << " seconds" << std::endl;
+    }
+
+    SimulationProfiler profiler;
+    profiler.Run();
+    if (tracer)
+    {
+        tracer->Close();
+    }
 
-    Simulator::Run();
+    // Goodput: payload delivered in order, from the client's start to the last delivery
+    double deliveryTime = serverApp->GetLastDeliveryTime().GetSeconds() - 2.0;
+    double goodput = deliveryTime > 0
+                         ? serverApp->GetTotalPacketsReceived() * packetSize * 8.0 / deliveryTime / 1000000.0
+                         : 0.0;
 
-    // Collect and display flow statistics
+    // Collect and display flow statistics (in place, without copying the flow table)
+    if (sampler)
+    {
+        sampler->Flush();
+    }
     flowMonitor->CheckForLostPackets();
-    Ptr<Ipv4FlowClassifier> classifier = DynamicCast<Ipv4FlowClassifier>(flowHelper.GetClassifier());
-    std::map<FlowId, FlowMonitor::FlowStats> stats = flowMonitor->GetFlowStats();
+    const FlowMonitor::FlowStatsContainer& stats = flowMonitor->GetFlowStats();
 
-    std::cout << "\n=== FLOW STATISTICS ===" << std::endl;
-    for (auto const &flow : stats)
+    if (textOutput)
     {
-        Ipv4FlowClassifier::FiveTuple t = classifier->FindFlow(flow.first);
+        std::cout << "\n=== FLOW STATISTICS ===" << std::endl;
+        for (auto const &flow : stats)
+        {
+            Ipv4FlowClassifier::FiveTuple t = classifier->FindFlow(flow.first);
         
-        std::cout << "Flow " << flow.first << " (" << t.sourceAddress << ":" << t.sourcePort 
-                  << " -> " << t.destinationAddress << ":" << t.destinationPort << ")" << std::endl;
-        std::cout << "  Tx Packets: " << flow.second.txPackets << std::endl;
-        std::cout << "  Rx Packets: " << flow.second.rxPackets << std::endl;
-        std::cout << "  Tx Bytes: " << flow.second.txBytes << std::endl;
-        std::cout << "  Rx Bytes: " << flow.second.rxBytes << std::endl;
+            std::cout << "Flow " << flow.first << " (" << t.sourceAddress << ":" << t.sourcePort 
+                      << " -> " << t.destinationAddress << ":" << t.destinationPort << ")" << std::endl;
+            std::cout << "  Tx Packets: " << flow.second.txPackets << std::endl;
+            std::cout << "  Rx Packets: " << flow.second.rxPackets << std::endl;
+            std::cout << "  Tx Bytes: " << flow.second.txBytes << std::endl;
+            std::cout << "  Rx Bytes: " << flow.second.rxBytes << std::endl;
         
-        if (flow.second.txPackets > 0)
-        {
-            double lossRate = (flow.second.txPackets - flow.second.rxPackets) * 100.0 / flow.second.txPackets;
-            std::cout << "  Packet Loss Rate: " << lossRate << "%" << std::endl;
-        }
+            if (flow.second.txPackets > 0)
+            {
+                double lossRate = (flow.second.txPackets - flow.second.rxPackets) * 100.0 / flow.second.txPackets;
+                std::cout << "  Packet Loss Rate: " << lossRate << "%" << std::endl;
+            }
         
-        if (flow.second.rxPackets > 0)
-        {
-            double throughput = flow.second.rxBytes * 8.0 / 
-                               (flow.second.timeLastRxPacket.GetSeconds() - 
-                                flow.second.timeFirstTxPacket.GetSeconds()) / 1000000.0;
-            double meanDelay = flow.second.delaySum.GetSeconds() / flow.second.rxPackets * 1000.0;
+            if (flow.second.rxPackets > 0)
+            {
+                double throughput = flow.second.rxBytes * 8.0 / 
+                                   (flow.second.timeLastRxPacket.GetSeconds() - 
+                                    flow.second.timeFirstTxPacket.GetSeconds()) / 1000000.0;
+                double meanDelay = flow.second.delaySum.GetSeconds() / flow.second.rxPackets * 1000.0;
             
-            std::cout << "  Throughput: " << throughput << " Mbps" << std::endl;
-            std::cout << "  Mean Delay: " << meanDelay << " ms" << std::endl;
+                std::cout << "  Throughput: " << throughput << " Mbps" << std::endl;
+                std::cout << "  Mean Delay: " << meanDelay << " ms" << std::endl;
+            }
+            std::cout << std::endl;
         }
-        std::cout << std::endl;
+        std::cout << "Client bytes allocated per delivered packet: "
+                  << clientApp->GetBytesAllocatedPerDelivered() << std::endl;
+        std::cout << "Goodput: " << goodput << " Mbps, server ACKs sent: " << serverApp->GetAcksSent()
+                  << " for " << serverApp->GetTotalPacketsReceived() << " delivered packets" << std::endl;
+        profiler.GetProfile().Print(std::cout);
+        std::cout << "Client effective throughput: " << clientApp->GetEffectiveThroughput() << " Mbps" << std::endl;
+        std::cout << "Client timeouts: " << clientApp->GetTimeouts()
+                  << ", timer events scheduled: " << clientApp->GetTimerSchedules()
+                  << ", smoothed RTT: " << clientApp->GetSmoothedRtt().GetSeconds() * 1000.0 << " ms"
+                  << ", final RTO: " << clientApp->GetRto().GetSeconds() * 1000.0 << " ms" << std::endl;
     }
 
+    // Aggregate the data direction of the reliable flow (to port 9)
+    FlowAggregator aggregator(classifier);
+    uint32_t dataGroup = aggregator.AddGroup("data");
+    aggregator.Map(Ipv4Address::GetAny(), 9, FlowAggregator::UDP, dataGroup);
+    aggregator.Aggregate(stats);
+    const FlowAggregator::GroupStats& dataFlows = aggregator.Get(dataGroup);
+    uint64_t flowTxPackets = dataFlows.txPackets;
+    uint64_t flowRxPackets = dataFlows.rxPackets;
+    uint64_t flowRxBytes = dataFlows.rxBytes;
+    double flowDelaySum = dataFlows.delaySum.GetSeconds();
+
+    ResultRecord record;
+    record.AddUint("run", RngSeedManager::GetRun())
+          .AddDouble("errorRate", errorRate)
+          .AddString("errorModel", config.errorModel)
+          .AddString("burstParams", config.burstParams)
+          .AddUint("perDeviceErrorModel", config.perDeviceErrorModel ? 1 : 0)
+          .AddUint("maxPackets", maxPackets)
+          .AddUint("packetSize", packetSize)
+          .AddDouble("interval", interval)
+          .AddDouble("timeout", timeout)
+          .AddUint("adaptiveRto", config.adaptiveRto ? 1 : 0)
+          .AddString("mode", config.mode)
+          .AddUint("windowSize", windowSize)
+          .AddUint("delayedAck", config.delayedAck ? 1 : 0)
+          .AddUint("ackEvery", config.ackEvery)
+          .AddDouble("ackDelay", config.ackDelay)
+          .AddDouble("simulationTime", simulationTime)
+          .AddUint("packetsSent", clientApp->GetTotalPacketsSent())
+          .AddUint("retransmissions", clientApp->GetRetransmissions())
+          .AddUint("bytesSent", clientApp->GetTotalBytesSent())
+          .AddUint("packetsDelivered", serverApp->GetTotalPacketsReceived())
+          .AddUint("packetsAcked", clientApp->GetPacketsAcked())
+          .AddUint("bytesAllocated", clientApp->GetBytesAllocated())
+          .AddDouble("bytesAllocatedPerDelivered", clientApp->GetBytesAllocatedPerDelivered())
+          .AddDouble("effectiveThroughput", clientApp->GetEffectiveThroughput())
+          .AddUint("timeouts", clientApp->GetTimeouts())
+          .AddUint("timerEvents", clientApp->GetTimerSchedules())
+          .AddDouble("srtt", clientApp->GetSmoothedRtt().GetSeconds() * 1000.0)
+          .AddDouble("finalRto", clientApp->GetRto().GetSeconds() * 1000.0)
+          .AddUint("acksSent", serverApp->GetAcksSent())
+          .AddDouble("goodput", goodput)
+          .AddUint("flowTxPackets", flowTxPackets)
+          .AddUint("flowRxPackets", flowRxPackets)
+          .AddUint("flowRxBytes", flowRxBytes)
+          .AddDouble("flowLossRate", flowTxPackets > 0 ? (flowTxPackets - flowRxPackets) * 100.0 / flowTxPackets : 0.0)
+          .AddDouble("flowMeanDelay", flowRxPackets > 0 ? flowDelaySum / flowRxPackets * 1000.0 : 0.0);
+    profiler.GetProfile().AddToRecord(record);
+    writer.Write(record);
+
+    // The sampler cancels its event, so it must go before the simulator
+    sampler.reset();
     Simulator::Destroy();
 
+    if (verbose)
+    {
+        // Do not leak this run's logging into the next batch line
+        LogComponentDisable("ReliableTransferSimulation", LOG_LEVEL_INFO);
+    }
+    return record;
+}
+
+// Run up to config.runs replications with consecutive RngRun values and
+// report the mean and 95% confidence interval of every metric. Stops early
+// once the CI_METRICS intervals are within config.ciTarget of their means.
+void
+RunReplications(const ExperimentConfig& config, ResultWriter& writer)
+{
+    if (config.runs <= 1)
+    {
+        RunExperiment(config, writer);
+        return;
+    }
+
+    AdaptiveSweep sweep(CI_METRICS, config.ciTarget, config.minRuns, config.runs);
+    ReplicationStats replications =
+        sweep.RunPoint([&config, &writer]() { return RunExperiment(config, writer); });
+
+    // Structured formats keep stdout for the per-run records
+    sweep.PrintSummary(writer.IsEnabled() ? std::cerr : std::cout, replications);
+}
+
+int
+main(int argc, char* argv[])
+{
+    ExperimentConfig config;
+    CommandLine cmd(__FILE__);
+    AddCommandLineOptions(cmd, config);
+    cmd.Parse(argc, argv);
+
+    // With a structured format, stdout carries only the result records; in
+    // batch mode every run writes to this one stream
+    ResultWriter writer(config.resultFormat,
+                        "reliable-transfer",
+                        RESULT_SCHEMA_VERSION,
+                        config.resultFile);
+
+    if (config.batchFile.empty())
+    {
+        RunReplications(config, writer);
+        return 0;
+    }
+
+    BatchRunner batch(argc, argv);
+    batch.Run(config.batchFile, [&writer](const std::vector<std::string>& args) {
+        ExperimentConfig lineConfig;
+        CommandLine lineCmd(__FILE__);
+        AddCommandLineOptions(lineCmd, lineConfig);
+        lineCmd.Parse(args);
+        RunReplications(lineConfig, writer);
+    });
+
     return 0;
 }
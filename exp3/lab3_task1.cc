@@ -11,32 +11,127 @@
 #include "ns3/point-to-point-module.h"
 #include "ns3/applications-module.h"
 #include "ns3/stats-module.h"
+#include "../common/adaptive-sweep.h"
+#include "../common/batch-runner.h"
+#include "../common/hot-path-log.h"
+#include "../common/recurring-event.h"
+#include "../common/result-writer.h"
+#include "../common/scheduler-type.h"
+#include "../common/simulation-profiler.h"
+#include "../common/steady-state-monitor.h"
+#include <memory>
 #include <vector>
-#include <cstring>
 
 using namespace ns3;
 
 NS_LOG_COMPONENT_DEFINE("Lab3Task1");
 
-// 全局统计变量
-uint32_t totalReceivedPackets = 0;
-uint32_t totalLostPackets = 0;
-double totalDelay = 0.0;
-uint32_t totalBytesReceived = 0;
+/**
+ * @brief 单次运行的统计
+ *
+ * 由 RunExperiment 为每次运行创建一份并交给收发两端的应用，进程中没有全局统计状态。
+ */
+struct Task1Stats {
+    uint32_t receivedPackets = 0;
+    uint32_t lostPackets = 0;
+    double totalDelay = 0.0;
+    uint32_t bytesReceived = 0;
+};
 
-// 简化自定义头部结构
-struct CustomHeader {
-    uint32_t sequenceNumber;
-    double sendTime;
-    uint32_t payloadSize;
-    
-    CustomHeader() : sequenceNumber(0), sendTime(0.0), payloadSize(0) {}
-    
-    static constexpr uint32_t GetSize() {
-        return sizeof(sequenceNumber) + sizeof(sendTime) + sizeof(payloadSize);
-    }
+/**
+ * @brief 自定义头部：序列号、发送时间、数据包总大小
+ *
+ * 按网络字节序序列化（发送时间为 TimeStep 计数），共 16 字节。
+ */
+class CustomHeader : public Header {
+public:
+    CustomHeader();
+    virtual ~CustomHeader();
+
+    static TypeId GetTypeId(void);
+    virtual TypeId GetInstanceTypeId(void) const;
+    virtual uint32_t GetSerializedSize(void) const;
+    virtual void Serialize(Buffer::Iterator start) const;
+    virtual uint32_t Deserialize(Buffer::Iterator start);
+    virtual void Print(std::ostream& os) const;
+    
+    void SetSequenceNumber(uint32_t seq);
+    uint32_t GetSequenceNumber(void) const;
+    void SetSendTime(Time sendTime);
+    Time GetSendTime(void) const;
+    void SetPayloadSize(uint32_t size);
+    uint32_t GetPayloadSize(void) const;
+
+private:
+    uint32_t m_sequenceNumber;
+    Time m_sendTime;
+    uint32_t m_payloadSize;
 };
 
+CustomHeader::CustomHeader() : m_sequenceNumber(0), m_sendTime(Seconds(0)), m_payloadSize(0) {
+}
+
+CustomHeader::~CustomHeader() {
+}
+
+TypeId CustomHeader::GetTypeId(void) {
+    static TypeId tid = TypeId("CustomHeader")
+        .SetParent<Header>()
+        .SetGroupName("Applications")
+        .AddConstructor<CustomHeader>();
+    return tid;
+}
+
+TypeId CustomHeader::GetInstanceTypeId(void) const {
+    return GetTypeId();
+}
+
+uint32_t CustomHeader::GetSerializedSize(void) const {
+    return sizeof(uint32_t) + sizeof(uint64_t) + sizeof(uint32_t);
+}
+
+void CustomHeader::Serialize(Buffer::Iterator start) const {
+    start.WriteHtonU32(m_sequenceNumber);
+    start.WriteHtonU64(static_cast<uint64_t>(m_sendTime.GetTimeStep()));
+    start.WriteHtonU32(m_payloadSize);
+}
+
+uint32_t CustomHeader::Deserialize(Buffer::Iterator start) {
+    m_sequenceNumber = start.ReadNtohU32();
+    m_sendTime = TimeStep(start.ReadNtohU64());
+    m_payloadSize = start.ReadNtohU32();
+    return GetSerializedSize();
+}
+
+void CustomHeader::Print(std::ostream& os) const {
+    os << "Seq: " << m_sequenceNumber << " SendTime: " << m_sendTime
+       << " Size: " << m_payloadSize;
+}
+
+void CustomHeader::SetSequenceNumber(uint32_t seq) {
+    m_sequenceNumber = seq;
+}
+
+uint32_t CustomHeader::GetSequenceNumber(void) const {
+    return m_sequenceNumber;
+}
+
+void CustomHeader::SetSendTime(Time sendTime) {
+    m_sendTime = sendTime;
+}
+
+Time CustomHeader::GetSendTime(void) const {
+    return m_sendTime;
+}
+
+void CustomHeader::SetPayloadSize(uint32_t size) {
+    m_payloadSize = size;
+}
+
+uint32_t CustomHeader::GetPayloadSize(void) const {
+    return m_payloadSize;
+}
+
 /**
  * @brief 接收端应用层，增强统计功能
  */
@@ -47,6 +142,8 @@ public:
 
     static TypeId GetTypeId(void);
     
+    void SetStats(Task1Stats* stats);
+    
 protected:
     virtual void DoDispose(void);
 
@@ -58,10 +155,12 @@ private:
     
     uint16_t m_port;
     Ptr<Socket> m_socket;
+    Task1Stats* m_stats;    // 本次运行的统计
 };
 
 EnhancedUdpServer::EnhancedUdpServer() : 
-    m_port(9) {
+    m_port(9),
+    m_stats(nullptr) {
 }
 
 EnhancedUdpServer::~EnhancedUdpServer() {
@@ -79,6 +178,10 @@ TypeId EnhancedUdpServer::GetTypeId(void) {
     return tid;
 }
 
+void EnhancedUdpServer::SetStats(Task1Stats* stats) {
+    m_stats = stats;
+}
+
 void EnhancedUdpServer::DoDispose(void) {
     NS_LOG_FUNCTION(this);
     if (m_socket) {
@@ -122,36 +225,253 @@ void EnhancedUdpServer::HandleRead(Ptr<Socket> socket) {
         uint32_t packetSize = packet->GetSize();
         
         // 检查数据包是否足够大以包含自定义头部
-        if (packetSize >= CustomHeader::GetSize()) {
-            // 提取自定义头部信息
-            uint8_t buffer[CustomHeader::GetSize()];
-            packet->CopyData(buffer, CustomHeader::GetSize());
-            
-            CustomHeader header;
-            std::memcpy(&header.sequenceNumber, buffer, sizeof(header.sequenceNumber));
-            std::memcpy(&header.sendTime, buffer + sizeof(header.sequenceNumber), sizeof(header.sendTime));
-            std::memcpy(&header.payloadSize, buffer + sizeof(header.sequenceNumber) + sizeof(header.sendTime), sizeof(header.payloadSize));
+        CustomHeader header;
+        if (packetSize >= header.GetSerializedSize()) {
+            // 直接在数据包缓冲区上解析头部，不复制载荷
+            packet->PeekHeader(header);
             
             // 计算延迟
-            double receiveTime = Simulator::Now().GetSeconds();
-            double delay = receiveTime - header.sendTime;
+            double delay = (Simulator::Now() - header.GetSendTime()).GetSeconds();
             
-            // 更新全局统计
-            totalReceivedPackets++;
-            totalBytesReceived += packetSize;
-            totalDelay += delay;
+            // 更新本次运行的统计
+            m_stats->receivedPackets++;
+            m_stats->bytesReceived += packetSize;
+            m_stats->totalDelay += delay;
             
-            NS_LOG_INFO("Packet " << header.sequenceNumber << " received with delay: " << delay * 1000 << "ms, size: " << packetSize << " bytes");
+            HOT_PATH_LOG_INFO("Packet " << header.GetSequenceNumber() << " received with delay: " << delay * 1000 << "ms, size: " << packetSize << " bytes");
         } else {
             NS_LOG_WARN("Received packet too small to contain custom header: " << packetSize << " bytes");
         }
     }
 }
 
+/**
+ * @brief AIMD 拥塞控制策略（原有的模拟方案，参数改为属性）
+ *
+ * 每发送 UpdateEvery 个包调整一次窗口：慢启动阶段加 2，拥塞避免阶段加 1；
+ * 调整时若已发送包数是 LossEvery 的倍数，则模拟一次丢包（计入 LossPackets 个丢包），
+ * 阈值减半、窗口回到 InitialCwnd。发送间隔为 1/cwnd 秒，不小于 MinInterval。
+ */
+class AimdPolicy {
+public:
+    static std::string GetName(void) { return "Aimd"; }
+    static TypeId AddAttributes(TypeId tid);
+    
+    void Reset(void);
+    
+    /**
+     * @brief 每成功发送一个包调用一次
+     * @param lostPackets 本次运行的丢包计数，模拟丢包时累加
+     * @return 下一个包的发送间隔
+     */
+    Time OnPacketSent(uint32_t packetsSent, uint32_t packetSize, Time interval, uint32_t& lostPackets) {
+        if (packetsSent % m_updateEvery != 0) {
+            return interval;
+        }
+        if (!m_congestionAvoidance) {
+            // 慢启动阶段 - 更温和的增长
+            m_cwnd = std::min(m_cwnd + 2, m_ssthresh);
+            if (m_cwnd >= m_ssthresh) {
+                m_congestionAvoidance = true;
+                NS_LOG_INFO("Entering congestion avoidance phase, cwnd: " << m_cwnd);
+            }
+        } else {
+            // 拥塞避免阶段 - 线性增长
+            m_cwnd += 1;
+        }
+        if (m_lossEvery > 0 && packetsSent % m_lossEvery == 0) {
+            m_ssthresh = std::max(m_cwnd / 2, m_initialCwnd);  // 确保阈值不会太小
+            m_cwnd = m_initialCwnd;  // 重置到合理值而不是1
+            m_congestionAvoidance = false;
+            NS_LOG_INFO("Simulated packet loss! ssthresh: " << m_ssthresh << " cwnd: " << m_cwnd);
+            lostPackets += m_lossPackets;
+        }
+        Time next = Seconds(std::max(1.0 / m_cwnd, m_minInterval.GetSeconds()));
+        NS_LOG_INFO("Congestion control: cwnd=" << m_cwnd << ", interval=" << next.GetSeconds() << "s");
+        return next;
+    }
+
+private:
+    uint32_t m_initialCwnd;
+    uint32_t m_initialSsthresh;
+    uint32_t m_updateEvery;
+    uint32_t m_lossEvery;
+    uint32_t m_lossPackets;
+    Time m_minInterval;
+    
+    uint32_t m_cwnd;
+    uint32_t m_ssthresh;
+    bool m_congestionAvoidance;
+};
+
+TypeId AimdPolicy::AddAttributes(TypeId tid) {
+    return tid
+        .AddAttribute("InitialCwnd", "Initial window in packets (also the window after a loss).",
+                     UintegerValue(4),
+                     MakeUintegerAccessor(&AimdPolicy::m_initialCwnd),
+                     MakeUintegerChecker<uint32_t>(1))
+        .AddAttribute("InitialSsthresh", "Initial slow-start threshold in packets.",
+                     UintegerValue(32),
+                     MakeUintegerAccessor(&AimdPolicy::m_initialSsthresh),
+                     MakeUintegerChecker<uint32_t>(1))
+        .AddAttribute("UpdateEvery", "Adjust the window every this many packets.",
+                     UintegerValue(15),
+                     MakeUintegerAccessor(&AimdPolicy::m_updateEvery),
+                     MakeUintegerChecker<uint32_t>(1))
+        .AddAttribute("LossEvery", "Simulate a loss at window updates on multiples of this packet count (0: never).",
+                     UintegerValue(40),
+                     MakeUintegerAccessor(&AimdPolicy::m_lossEvery),
+                     MakeUintegerChecker<uint32_t>())
+        .AddAttribute("LossPackets", "Packets counted as lost per simulated loss.",
+                     UintegerValue(2),
+                     MakeUintegerAccessor(&AimdPolicy::m_lossPackets),
+                     MakeUintegerChecker<uint32_t>())
+        .AddAttribute("MinInterval", "Smallest interval between packets.",
+                     TimeValue(MilliSeconds(1)),
+                     MakeTimeAccessor(&AimdPolicy::m_minInterval),
+                     MakeTimeChecker());
+}
+
+void AimdPolicy::Reset(void) {
+    m_cwnd = m_initialCwnd;
+    m_ssthresh = m_initialSsthresh;
+    m_congestionAvoidance = false;
+}
+
+/**
+ * @brief 固定速率策略：按 DataRate 匀速发送，间隔为包的发送时间
+ */
+class RatePolicy {
+public:
+    static std::string GetName(void) { return "Rate"; }
+    static TypeId AddAttributes(TypeId tid);
+    
+    void Reset(void) {}
+    
+    Time OnPacketSent(uint32_t packetsSent, uint32_t packetSize, Time interval, uint32_t& lostPackets) {
+        return m_rate.CalculateBytesTxTime(packetSize);
+    }
+
+private:
+    DataRate m_rate;
+};
+
+TypeId RatePolicy::AddAttributes(TypeId tid) {
+    return tid
+        .AddAttribute("DataRate", "Sending rate.",
+                     DataRateValue(DataRate("1Mbps")),
+                     MakeDataRateAccessor(&RatePolicy::m_rate),
+                     MakeDataRateChecker());
+}
+
+/**
+ * @brief 类 BBR 的开环步调策略
+ *
+ * UDP 客户端没有反馈，瓶颈带宽 BottleneckRate 和往返时间 MinRtt 作为已知参数：
+ * STARTUP 阶段从每个 MinRtt 发送 InitialWindow 个包开始，每个 MinRtt 把速率乘以
+ * StartupGain，超过瓶颈带宽后进入 DRAIN（速率为 带宽/StartupGain，持续一个 MinRtt），
+ * 然后进入 PROBE_BW，按 {CycleGain, 2-CycleGain, 1, 1, 1, 1, 1, 1} 每个 MinRtt 轮换增益。
+ */
+class BbrPacingPolicy {
+public:
+    static std::string GetName(void) { return "Bbr"; }
+    static TypeId AddAttributes(TypeId tid);
+    
+    void Reset(void);
+    
+    Time OnPacketSent(uint32_t packetsSent, uint32_t packetSize, Time interval, uint32_t& lostPackets) {
+        Time now = Simulator::Now();
+        double bottleneck = m_bottleneck.GetBitRate();
+        if (m_pacingRate <= 0) {
+            m_pacingRate = m_initialWindow * packetSize * 8.0 / m_minRtt.GetSeconds();
+            m_phaseStart = now;
+        }
+        if (now - m_phaseStart >= m_minRtt) {
+            m_phaseStart = now;
+            switch (m_phase) {
+            case STARTUP:
+                m_pacingRate *= m_startupGain;
+                if (m_pacingRate >= bottleneck) {
+                    m_phase = DRAIN;
+                    m_pacingRate = bottleneck / m_startupGain;
+                    NS_LOG_INFO("BBR pacing: leaving startup, draining at " << m_pacingRate << " bps");
+                }
+                break;
+            case DRAIN:
+                m_phase = PROBE_BW;
+                m_cycleIndex = 0;
+                m_pacingRate = bottleneck * m_cycleGain;
+                break;
+            case PROBE_BW:
+                m_cycleIndex = (m_cycleIndex + 1) % CYCLE_LENGTH;
+                m_pacingRate = bottleneck * (m_cycleIndex == 0   ? m_cycleGain
+                                             : m_cycleIndex == 1 ? 2.0 - m_cycleGain
+                                                                 : 1.0);
+                break;
+            }
+        }
+        return Seconds(packetSize * 8.0 / m_pacingRate);
+    }
+
+private:
+    enum Phase { STARTUP, DRAIN, PROBE_BW };
+    static const uint32_t CYCLE_LENGTH = 8;
+    
+    DataRate m_bottleneck;
+    Time m_minRtt;
+    uint32_t m_initialWindow;
+    double m_startupGain;
+    double m_cycleGain;
+    
+    Phase m_phase;
+    double m_pacingRate;    // bit/s，0 表示尚未初始化
+    Time m_phaseStart;
+    uint32_t m_cycleIndex;
+};
+
+TypeId BbrPacingPolicy::AddAttributes(TypeId tid) {
+    return tid
+        .AddAttribute("BottleneckRate", "Assumed bottleneck bandwidth.",
+                     DataRateValue(DataRate("5Mbps")),
+                     MakeDataRateAccessor(&BbrPacingPolicy::m_bottleneck),
+                     MakeDataRateChecker())
+        .AddAttribute("MinRtt", "Assumed round-trip time; every phase lasts one MinRtt.",
+                     TimeValue(MilliSeconds(10)),
+                     MakeTimeAccessor(&BbrPacingPolicy::m_minRtt),
+                     MakeTimeChecker(NanoSeconds(1)))
+        .AddAttribute("InitialWindow", "Packets per MinRtt at the start of STARTUP.",
+                     UintegerValue(4),
+                     MakeUintegerAccessor(&BbrPacingPolicy::m_initialWindow),
+                     MakeUintegerChecker<uint32_t>(1))
+        .AddAttribute("StartupGain", "Rate gain per MinRtt during STARTUP.",
+                     DoubleValue(2.885),
+                     MakeDoubleAccessor(&BbrPacingPolicy::m_startupGain),
+                     MakeDoubleChecker<double>(1.0))
+        .AddAttribute("CycleGain", "Probing gain of the PROBE_BW cycle.",
+                     DoubleValue(1.25),
+                     MakeDoubleAccessor(&BbrPacingPolicy::m_cycleGain),
+                     MakeDoubleChecker<double>(1.0, 2.0));
+}
+
+void BbrPacingPolicy::Reset(void) {
+    m_phase = STARTUP;
+    m_pacingRate = 0;
+    m_cycleIndex = 0;
+}
+
 /**
  * @brief 增强的UDP客户端，支持可变数据包大小和拥塞控制模拟
+ *
+ * 拥塞控制策略 Policy 在编译期选定（AimdPolicy、RatePolicy、BbrPacingPolicy），
+ * 每个包的处理路径直接内联策略代码，不在运行时按标志分支。策略的参数注册为本类型的
+ * 属性，例如 --EnhancedUdpClientAimd::UpdateEvery=10。
+ *
+ * BurstTick 大于 0 时进入突发步调模式：每个定时周期只调度一个事件，一次发出所有
+ * 虚拟发送时间已到的包（按策略间隔累加，不受定时周期取整），事件数随每周期的包数下降，
+ * 高速率下也能打满链路。
  */
-class EnhancedUdpClient : public Application {
+template <typename Policy>
+class EnhancedUdpClient : public Application, public Policy {
 public:
     EnhancedUdpClient();
     virtual ~EnhancedUdpClient();
@@ -162,6 +482,7 @@ public:
     void SetPacketSize(uint32_t size);
     void SetMaxPackets(uint32_t max);
     void SetInterval(Time interval);
+    void SetStats(Task1Stats* stats);
 
 protected:
     virtual void DoDispose(void);
@@ -172,63 +493,73 @@ private:
     
     void ScheduleTransmit(void);
     void SendPacket(void);
-    
-    // 拥塞控制相关函数
-    void CongestionControl(void);
+    void SendBurst(void);
+    bool SendOne(void);
     
     Ptr<Socket> m_socket;
     Address m_peerAddress;
     EventId m_sendEvent;
+    // 发送定时器复用事件对象，避免每个包分配一次（见 recurring-event.h）
+    RecurringEvent<EnhancedUdpClient<Policy>> m_packetEvents;
+    RecurringEvent<EnhancedUdpClient<Policy>> m_burstEvents;
     
     uint32_t m_packetSize;
     uint32_t m_maxPackets;
     uint32_t m_packetsSent;
     Time m_interval;
-    
-    // 拥塞控制参数 - 修复：使用更合理的初始值
-    uint32_t m_cwnd;
-    uint32_t m_ssthresh;
-    bool m_congestionAvoidance;
+    Time m_burstTick;       // 0 表示每个包调度一个事件
+    Time m_nextSendTime;    // 突发模式下下一个包的虚拟发送时间
     
     uint32_t m_sequenceNumber;
+    Task1Stats* m_stats;    // 本次运行的统计
 };
 
-EnhancedUdpClient::EnhancedUdpClient() : 
+template <typename Policy>
+EnhancedUdpClient<Policy>::EnhancedUdpClient() : 
     m_socket(0),
+    m_packetEvents(this, &EnhancedUdpClient<Policy>::SendPacket),
+    m_burstEvents(this, &EnhancedUdpClient<Policy>::SendBurst),
     m_packetSize(1024),
     m_maxPackets(100),
     m_packetsSent(0),
     m_interval(Seconds(0.05)),  // 修复：更合理的初始间隔
-    m_cwnd(4),                  // 修复：更大的初始窗口
-    m_ssthresh(32),             // 修复：更高的慢启动阈值
-    m_congestionAvoidance(false),
-    m_sequenceNumber(0) {
+    m_burstTick(Seconds(0)),
+    m_sequenceNumber(0),
+    m_stats(nullptr) {
 }
 
-EnhancedUdpClient::~EnhancedUdpClient() {
+template <typename Policy>
+EnhancedUdpClient<Policy>::~EnhancedUdpClient() {
 }
 
-TypeId EnhancedUdpClient::GetTypeId(void) {
-    static TypeId tid = TypeId("EnhancedUdpClient")
-        .SetParent<Application>()
-        .SetGroupName("Applications")
-        .AddConstructor<EnhancedUdpClient>()
-        .AddAttribute("PacketSize", "The size of packets transmitted.",
-                     UintegerValue(1024),
-                     MakeUintegerAccessor(&EnhancedUdpClient::m_packetSize),
-                     MakeUintegerChecker<uint32_t>())
-        .AddAttribute("MaxPackets", "The maximum number of packets the application will send.",
-                     UintegerValue(100),
-                     MakeUintegerAccessor(&EnhancedUdpClient::m_maxPackets),
-                     MakeUintegerChecker<uint32_t>())
-        .AddAttribute("Interval", "The time to wait between packets.",
-                     TimeValue(Seconds(0.05)),
-                     MakeTimeAccessor(&EnhancedUdpClient::m_interval),
-                     MakeTimeChecker());
+template <typename Policy>
+TypeId EnhancedUdpClient<Policy>::GetTypeId(void) {
+    static TypeId tid = Policy::AddAttributes(
+        TypeId("EnhancedUdpClient" + Policy::GetName())
+            .SetParent<Application>()
+            .SetGroupName("Applications")
+            .template AddConstructor<EnhancedUdpClient<Policy>>()
+            .AddAttribute("PacketSize", "The size of packets transmitted.",
+                         UintegerValue(1024),
+                         MakeUintegerAccessor(&EnhancedUdpClient<Policy>::m_packetSize),
+                         MakeUintegerChecker<uint32_t>())
+            .AddAttribute("MaxPackets", "The maximum number of packets the application will send.",
+                         UintegerValue(100),
+                         MakeUintegerAccessor(&EnhancedUdpClient<Policy>::m_maxPackets),
+                         MakeUintegerChecker<uint32_t>())
+            .AddAttribute("Interval", "The time to wait before the first packet (the policy sets later intervals).",
+                         TimeValue(Seconds(0.05)),
+                         MakeTimeAccessor(&EnhancedUdpClient<Policy>::m_interval),
+                         MakeTimeChecker())
+            .AddAttribute("BurstTick", "Pacing timer period: send every due packet once per tick (0: one event per packet).",
+                         TimeValue(Seconds(0)),
+                         MakeTimeAccessor(&EnhancedUdpClient<Policy>::m_burstTick),
+                         MakeTimeChecker(Seconds(0))));
     return tid;
 }
 
-void EnhancedUdpClient::DoDispose(void) {
+template <typename Policy>
+void EnhancedUdpClient<Policy>::DoDispose(void) {
     NS_LOG_FUNCTION(this);
     if (m_socket) {
         m_socket->Close();
@@ -237,27 +568,37 @@ void EnhancedUdpClient::DoDispose(void) {
     Application::DoDispose();
 }
 
-void EnhancedUdpClient::SetRemote(Address addr) {
+template <typename Policy>
+void EnhancedUdpClient<Policy>::SetRemote(Address addr) {
     NS_LOG_FUNCTION(this << addr);
     m_peerAddress = addr;
 }
 
-void EnhancedUdpClient::SetPacketSize(uint32_t size) {
+template <typename Policy>
+void EnhancedUdpClient<Policy>::SetPacketSize(uint32_t size) {
     NS_LOG_FUNCTION(this << size);
     m_packetSize = size;
 }
 
-void EnhancedUdpClient::SetMaxPackets(uint32_t max) {
+template <typename Policy>
+void EnhancedUdpClient<Policy>::SetMaxPackets(uint32_t max) {
     NS_LOG_FUNCTION(this << max);
     m_maxPackets = max;
 }
 
-void EnhancedUdpClient::SetInterval(Time interval) {
+template <typename Policy>
+void EnhancedUdpClient<Policy>::SetInterval(Time interval) {
     NS_LOG_FUNCTION(this << interval);
     m_interval = interval;
 }
 
-void EnhancedUdpClient::StartApplication(void) {
+template <typename Policy>
+void EnhancedUdpClient<Policy>::SetStats(Task1Stats* stats) {
+    m_stats = stats;
+}
+
+template <typename Policy>
+void EnhancedUdpClient<Policy>::StartApplication(void) {
     NS_LOG_FUNCTION(this);
     
     if (!m_socket) {
@@ -272,10 +613,12 @@ void EnhancedUdpClient::StartApplication(void) {
     m_socket->Connect(m_peerAddress);
     NS_LOG_INFO("UDP Client started, connecting to " << m_peerAddress);
     
+    Policy::Reset();
     ScheduleTransmit();
 }
 
-void EnhancedUdpClient::StopApplication(void) {
+template <typename Policy>
+void EnhancedUdpClient<Policy>::StopApplication(void) {
     NS_LOG_FUNCTION(this);
     
     if (m_socket) {
@@ -287,12 +630,19 @@ void EnhancedUdpClient::StopApplication(void) {
     }
 }
 
-void EnhancedUdpClient::ScheduleTransmit(void) {
+template <typename Policy>
+void EnhancedUdpClient<Policy>::ScheduleTransmit(void) {
     NS_LOG_FUNCTION(this);
-    m_sendEvent = Simulator::Schedule(m_interval, &EnhancedUdpClient::SendPacket, this);
+    if (m_burstTick.IsStrictlyPositive()) {
+        m_nextSendTime = Simulator::Now() + m_interval;
+        m_sendEvent = m_burstEvents.Schedule(m_interval);
+    } else {
+        m_sendEvent = m_packetEvents.Schedule(m_interval);
+    }
 }
 
-void EnhancedUdpClient::SendPacket(void) {
+template <typename Policy>
+void EnhancedUdpClient<Policy>::SendPacket(void) {
     NS_LOG_FUNCTION(this);
     
     if (m_packetsSent >= m_maxPackets) {
@@ -300,111 +650,175 @@ void EnhancedUdpClient::SendPacket(void) {
         return;
     }
     
-    // 创建自定义头部
-    CustomHeader header;
-    header.sequenceNumber = m_sequenceNumber++;
-    header.sendTime = Simulator::Now().GetSeconds();
-    header.payloadSize = m_packetSize;
-    
-    // 序列化头部
-    uint8_t headerBuffer[CustomHeader::GetSize()];
-    std::memcpy(headerBuffer, &header.sequenceNumber, sizeof(header.sequenceNumber));
-    std::memcpy(headerBuffer + sizeof(header.sequenceNumber), &header.sendTime, sizeof(header.sendTime));
-    std::memcpy(headerBuffer + sizeof(header.sequenceNumber) + sizeof(header.sendTime), &header.payloadSize, sizeof(header.payloadSize));
-    
-    // 创建完整的数据包 - 修复：确保总大小正确
-    uint32_t totalPacketSize = m_packetSize;
-    uint32_t payloadSize = totalPacketSize - CustomHeader::GetSize();
-    
-    // 创建包含头部的数据包
-    Ptr<Packet> packet = Create<Packet>(headerBuffer, CustomHeader::GetSize());
-    
-    // 如果需要，添加有效载荷
-    if (payloadSize > 0) {
-        Ptr<Packet> payload = Create<Packet>(payloadSize);
-        packet->AddAtEnd(payload);
-    }
-    
-    // 发送数据包
-    int actualBytes = m_socket->Send(packet);
-    if (actualBytes > 0) {
-        m_packetsSent++;
-        NS_LOG_INFO("Sending packet " << header.sequenceNumber << " at time " << header.sendTime << ", size: " << actualBytes << " bytes");
-        
-        // 模拟拥塞控制 - 修复：更温和的控制
-        if (m_packetsSent % 15 == 0) {  // 减少触发频率
-            CongestionControl();
-        }
-        
+    if (SendOne()) {
         if (m_packetsSent < m_maxPackets) {
             ScheduleTransmit();
         } else {
             NS_LOG_INFO("Finished sending all " << m_maxPackets << " packets");
         }
-    } else {
-        NS_LOG_ERROR("Failed to send packet " << header.sequenceNumber);
-        totalLostPackets++;
     }
 }
 
-void EnhancedUdpClient::CongestionControl(void) {
+template <typename Policy>
+void EnhancedUdpClient<Policy>::SendBurst(void) {
     NS_LOG_FUNCTION(this);
     
-    // 修复：更温和的拥塞控制
-    if (!m_congestionAvoidance) {
-        // 慢启动阶段 - 更温和的增长
-        m_cwnd = std::min(m_cwnd + 2, m_ssthresh);
-        if (m_cwnd >= m_ssthresh) {
-            m_congestionAvoidance = true;
-            NS_LOG_INFO("Entering congestion avoidance phase, cwnd: " << m_cwnd);
-        }
-    } else {
-        // 拥塞避免阶段 - 线性增长
-        m_cwnd += 1;
+    // 发出所有到期的包；发送失败时停止本轮，下一个周期再试
+    Time now = Simulator::Now();
+    uint32_t train = 0;
+    while (m_nextSendTime <= now && m_packetsSent < m_maxPackets && SendOne()) {
+        m_nextSendTime += m_interval;
+        train++;
     }
+    HOT_PATH_LOG_INFO("Sent a train of " << train << " packets");
     
-    // 修复：更少的模拟丢包事件
-    if (m_packetsSent % 40 == 0 && m_packetsSent > 0) {  // 减少丢包频率
-        m_ssthresh = std::max(m_cwnd / 2, 4u);  // 确保阈值不会太小
-        m_cwnd = 4;  // 重置到合理值而不是1
-        m_congestionAvoidance = false;
-        NS_LOG_INFO("Simulated packet loss! ssthresh: " << m_ssthresh << " cwnd: " << m_cwnd);
-        totalLostPackets += 2;  // 模拟少量丢包
+    if (m_packetsSent < m_maxPackets) {
+        Time wait = std::max(m_burstTick, m_nextSendTime - now);
+        m_sendEvent = m_burstEvents.Schedule(wait);
+    } else {
+        NS_LOG_INFO("Finished sending all " << m_maxPackets << " packets");
     }
+}
+
+/**
+ * @brief 组装并发送一个包，成功后由策略更新发送间隔
+ * @return 发送是否成功
+ */
+template <typename Policy>
+bool EnhancedUdpClient<Policy>::SendOne(void) {
+    // 创建自定义头部
+    CustomHeader header;
+    header.SetSequenceNumber(m_sequenceNumber++);
+    header.SetSendTime(Simulator::Now());
+    header.SetPayloadSize(m_packetSize);
     
-    // 调整发送间隔 - 修复：限制最小间隔
-    double minInterval = 0.001;  // 最小1ms间隔
-    double calculatedInterval = 1.0 / m_cwnd;
-    m_interval = Seconds(std::max(calculatedInterval, minInterval));
+    // 创建完整的数据包 - 修复：确保总大小正确
+    // 载荷为零填充的虚拟字节（不分配内存），头部直接写入同一个数据包
+    uint32_t headerSize = header.GetSerializedSize();
+    uint32_t payloadSize = (m_packetSize > headerSize) ? m_packetSize - headerSize : 0;
+    Ptr<Packet> packet = Create<Packet>(payloadSize);
+    packet->AddHeader(header);
     
-    NS_LOG_INFO("Congestion control: cwnd=" << m_cwnd << ", interval=" << m_interval.GetSeconds() << "s");
+    // 发送数据包
+    int actualBytes = m_socket->Send(packet);
+    if (actualBytes > 0) {
+        m_packetsSent++;
+        HOT_PATH_LOG_INFO("Sending packet " << header.GetSequenceNumber() << " at time " << header.GetSendTime().GetSeconds() << ", size: " << actualBytes << " bytes");
+        
+        // 由拥塞控制策略决定下一个包的发送间隔（编译期绑定，内联调用）
+        m_interval = Policy::OnPacketSent(m_packetsSent, m_packetSize, m_interval, m_stats->lostPackets);
+        return true;
+    }
+    NS_LOG_ERROR("Failed to send packet " << header.GetSequenceNumber());
+    m_stats->lostPackets++;
+    return false;
 }
 
+// 程序启动时注册三种客户端类型，命令行才能在创建对象之前设置它们的属性
+NS_OBJECT_TEMPLATE_CLASS_DEFINE(EnhancedUdpClient, AimdPolicy);
+NS_OBJECT_TEMPLATE_CLASS_DEFINE(EnhancedUdpClient, RatePolicy);
+NS_OBJECT_TEMPLATE_CLASS_DEFINE(EnhancedUdpClient, BbrPacingPolicy);
+
 /**
- * @brief 主函数
+ * @brief 创建指定策略的UDP客户端并安装到节点上
  */
-int main(int argc, char *argv[]) {
-    // 配置参数
+template <typename Policy>
+Ptr<Application> InstallClient(Ptr<Node> node, Address remote, uint32_t packetSize, uint32_t maxPackets,
+                               Time burstTick, Task1Stats* stats) {
+    Ptr<EnhancedUdpClient<Policy>> client = CreateObject<EnhancedUdpClient<Policy>>();
+    client->SetRemote(remote);
+    client->SetPacketSize(packetSize);
+    client->SetMaxPackets(maxPackets);
+    client->SetInterval(Seconds(0.05));
+    client->SetAttribute("BurstTick", TimeValue(burstTick));
+    client->SetStats(stats);
+    node->AddApplication(client);
+    return client;
+}
+
+/**
+ * @brief 按名称选择拥塞控制策略（只在安装时分支一次）
+ */
+Ptr<Application> InstallClient(const std::string& policy, Ptr<Node> node, Address remote,
+                               uint32_t packetSize, uint32_t maxPackets, Time burstTick,
+                               Task1Stats* stats) {
+    if (policy == AimdPolicy::GetName()) {
+        return InstallClient<AimdPolicy>(node, remote, packetSize, maxPackets, burstTick, stats);
+    } else if (policy == RatePolicy::GetName()) {
+        return InstallClient<RatePolicy>(node, remote, packetSize, maxPackets, burstTick, stats);
+    } else if (policy == BbrPacingPolicy::GetName()) {
+        return InstallClient<BbrPacingPolicy>(node, remote, packetSize, maxPackets, burstTick, stats);
+    }
+    NS_FATAL_ERROR("Unknown congestion control policy '" << policy << "' (expected Aimd, Rate or Bbr)");
+    return 0;
+}
+
+/**
+ * @brief 单次实验的配置
+ */
+struct Task1Config {
     uint32_t packetSize = 1024;
     uint32_t maxPackets = 100;
     double simulationTime = 20.0;
     std::string dataRate = "5Mbps";
     std::string delay = "2ms";
+    std::string policy = "Aimd";
+    double burstTick = 0.0;
+    uint32_t runs = 1;
+    uint32_t minRuns = 3;
+    double ciTarget = 0.05;
+    bool steadyState = false;
+    double sampleInterval = 0.1;
+    uint32_t minSteadyBatches = 10;
+    std::string resultFormat = "text";
+    std::string resultFile;
+    std::string batchFile;
+    std::string scheduler = "map";
+};
+
+/**
+ * @brief 注册命令行参数（批处理模式下每一行都用它重新解析）
+ */
+void AddCommandLineOptions(CommandLine& cmd, Task1Config& config) {
+    cmd.AddValue("packetSize", "Packet size in bytes", config.packetSize);
+    cmd.AddValue("maxPackets", "Total number of packets to send", config.maxPackets);
+    cmd.AddValue("simulationTime", "Simulation time in seconds", config.simulationTime);
+    cmd.AddValue("dataRate", "PointToPoint link data rate", config.dataRate);
+    cmd.AddValue("delay", "PointToPoint link delay", config.delay);
+    cmd.AddValue("policy", "Client congestion control policy (Aimd, Rate, Bbr); tune with --EnhancedUdpClient<policy>::<attribute>", config.policy);
+    cmd.AddValue("burstTick", "Client pacing timer in seconds: send a train of due packets per tick (0: one event per packet)", config.burstTick);
+    cmd.AddValue("runs", "Maximum number of independent replications (RngRun, RngRun+1, ...)", config.runs);
+    cmd.AddValue("minRuns", "Replications to run before stopping early is considered", config.minRuns);
+    cmd.AddValue("ciTarget", "Stop once the 95% CI half-width of throughput and delay is below this fraction of the mean", config.ciTarget);
+    cmd.AddValue("steadyState", "Stop the simulation once the receive rate is steady (MSER-5)", config.steadyState);
+    cmd.AddValue("sampleInterval", "Receive-rate sampling interval for --steadyState, in seconds", config.sampleInterval);
+    cmd.AddValue("minSteadyBatches", "Batches of 5 samples required after the warm-up before stopping", config.minSteadyBatches);
+    cmd.AddValue("resultFormat", "Result output format (text, csv, jsonl, bin)", config.resultFormat);
+    cmd.AddValue("resultFile", "Result output file for csv/jsonl/bin (default: stdout)", config.resultFile);
+    cmd.AddValue("batch", "Batch file: run one configuration per line in this process", config.batchFile);
+    cmd.AddValue("scheduler", "Event scheduler (map, list, heap, calendar, priority)", config.scheduler);
+}
+
+/// 置信区间收敛判据所用的指标
+const std::vector<std::string> CI_METRICS = {"throughput", "avgDelay"};
+
+// 结果记录的schema版本，字段含义或顺序变化时递增
+const uint32_t RESULT_SCHEMA_VERSION = 6;
+
+/**
+ * @brief 运行一次实验并输出结果
+ * @return 本次运行的结果记录（文本模式下也会构造，供重复实验统计）
+ */
+ResultRecord RunExperiment(const Task1Config& config, ResultWriter& writer) {
+    uint32_t packetSize = config.packetSize;
+    uint32_t maxPackets = config.maxPackets;
+    double simulationTime = config.simulationTime;
+    const std::string& dataRate = config.dataRate;
+    const std::string& delay = config.delay;
+    SetSchedulerType(config.scheduler);
     
-    // 命令行参数解析
-    CommandLine cmd;
-    cmd.AddValue("packetSize", "Packet size in bytes", packetSize);
-    cmd.AddValue("maxPackets", "Total number of packets to send", maxPackets);
-    cmd.AddValue("simulationTime", "Simulation time in seconds", simulationTime);
-    cmd.AddValue("dataRate", "PointToPoint link data rate", dataRate);
-    cmd.AddValue("delay", "PointToPoint link delay", delay);
-    cmd.Parse(argc, argv);
-    
-    // 重置全局统计变量
-    totalReceivedPackets = 0;
-    totalBytesReceived = 0;
-    totalDelay = 0.0;
-    totalLostPackets = 0;
+    // 本次运行的统计，仿真结束前一直有效
+    Task1Stats stats;
     
     // 创建节点
     NodeContainer nodes;
@@ -418,8 +832,9 @@ int main(int argc, char *argv[]) {
     NetDeviceContainer devices;
     devices = pointToPoint.Install(nodes);
     
-    // 安装协议栈
+    // 安装协议栈（只分配IPv4地址，不安装IPv6）
     InternetStackHelper stack;
+    stack.SetIpv6StackInstall(false);
     stack.Install(nodes);
     
     // 分配IP地址
@@ -431,18 +846,15 @@ int main(int argc, char *argv[]) {
     uint16_t port = 9;
     Ptr<EnhancedUdpServer> server = CreateObject<EnhancedUdpServer>();
     server->SetAttribute("Port", UintegerValue(port));
+    server->SetStats(&stats);
     nodes.Get(1)->AddApplication(server);
     server->SetStartTime(Seconds(1.0));
     server->SetStopTime(Seconds(simulationTime));
     
     // 设置UDP客户端
-    Ptr<EnhancedUdpClient> client = CreateObject<EnhancedUdpClient>();
     InetSocketAddress remoteAddr = InetSocketAddress(interfaces.GetAddress(1), port);
-    client->SetRemote(remoteAddr);
-    client->SetPacketSize(packetSize);
-    client->SetMaxPackets(maxPackets);
-    client->SetInterval(Seconds(0.05));
-    nodes.Get(0)->AddApplication(client);
+    Ptr<Application> client = InstallClient(config.policy, nodes.Get(0), remoteAddr, packetSize, maxPackets,
+                                            Seconds(config.burstTick), &stats);
     client->SetStartTime(Seconds(2.0));
     client->SetStopTime(Seconds(simulationTime - 1));
     
@@ -451,35 +863,143 @@ int main(int argc, char *argv[]) {
     // LogComponentEnable("EnhancedUdpClient", LOG_LEVEL_INFO);
     // LogComponentEnable("EnhancedUdpServer", LOG_LEVEL_INFO);
     
-    std::cout << "Starting simulation with parameters:" << std::endl;
-    std::cout << "  Packet Size: " << packetSize << " bytes" << std::endl;
-    std::cout << "  Max Packets: " << maxPackets << std::endl;
-    std::cout << "  Simulation Time: " << simulationTime << " seconds" << std::endl;
-    std::cout << "  Data Rate: " << dataRate << std::endl;
-    std::cout << "  Delay: " << delay << std::endl;
+    if (!writer.IsEnabled()) {
+        std::cout << "Starting simulation with parameters:" << std::endl;
+        std::cout << "  Packet Size: " << packetSize << " bytes" << std::endl;
+        std::cout << "  Max Packets: " << maxPackets << std::endl;
+        std::cout << "  Simulation Time: " << simulationTime << " seconds" << std::endl;
+        std::cout << "  Data Rate: " << dataRate << std::endl;
+        std::cout << "  Delay: " << delay << std::endl;
+        std::cout << "  Policy: " << config.policy << std::endl;
+    }
+    
+    // 稳态检测：从客户端启动开始采样接收速率，MSER-5 判定进入稳态后提前结束仿真
+    std::unique_ptr<SteadyStateMonitor> monitor;
+    if (config.steadyState) {
+        monitor.reset(new SteadyStateMonitor([&stats]() { return static_cast<double>(stats.bytesReceived); },
+                                             Seconds(config.sampleInterval),
+                                             config.minSteadyBatches));
+        monitor->Start(Seconds(2.0));
+    }
     
     // 运行仿真
     Simulator::Stop(Seconds(simulationTime));
-    Simulator::Run();
-    
-    // 输出统计结果
-    double throughput = (totalBytesReceived * 8.0) / (simulationTime * 1000000.0); // Mbps
-    double averageDelay = totalReceivedPackets > 0 ? totalDelay / totalReceivedPackets : 0;
+    SimulationProfiler profiler;
+    profiler.Run();
+    const SimulationProfile& profile = profiler.GetProfile();
+    uint64_t events = profile.events;
+    double simulatedTime = Simulator::Now().GetSeconds();
+    bool steady = monitor && monitor->IsSteady();
+    double warmupEnd = steady ? monitor->GetWarmupEnd().GetSeconds() : 0.0;
+    
+    // 输出统计结果；进入稳态时吞吐量取截断预热期之后的平均接收速率
+    double throughput = steady ? monitor->GetSteadyRate() * 8.0 / 1000000.0
+                               : (stats.bytesReceived * 8.0) / (simulationTime * 1000000.0); // Mbps
+    double averageDelay = stats.receivedPackets > 0 ? stats.totalDelay / stats.receivedPackets : 0;
     double packetLossRate = (maxPackets > 0) ? 
-        (double)(maxPackets - totalReceivedPackets) / maxPackets : 0;
-    
-    std::cout << "\n=== 网络性能统计结果 ===" << std::endl;
-    std::cout << "仿真时间: " << simulationTime << " 秒" << std::endl;
-    std::cout << "数据包大小: " << packetSize << " 字节" << std::endl;
-    std::cout << "发送数据包总数: " << maxPackets << std::endl;
-    std::cout << "接收数据包总数: " << totalReceivedPackets << std::endl;
-    std::cout << "总接收字节数: " << totalBytesReceived << " 字节" << std::endl;
-    std::cout << "网络吞吐量: " << throughput << " Mbps" << std::endl;
-    std::cout << "平均延迟: " << averageDelay * 1000 << " ms" << std::endl;
-    std::cout << "丢包率: " << packetLossRate * 100 << "%" << std::endl;
-    std::cout << "========================\n" << std::endl;
+        (double)(maxPackets - stats.receivedPackets) / maxPackets : 0;
+    
+    ResultRecord record;
+    record.AddUint("run", RngSeedManager::GetRun())
+          .AddUint("packetSize", packetSize)
+          .AddUint("maxPackets", maxPackets)
+          .AddDouble("simulationTime", simulationTime)
+          .AddString("dataRate", dataRate)
+          .AddString("delay", delay)
+          .AddString("policy", config.policy)
+          .AddDouble("burstTick", config.burstTick)
+          .AddUint("receivedPackets", stats.receivedPackets)
+          .AddUint("bytesReceived", stats.bytesReceived)
+          .AddUint("lostPackets", stats.lostPackets)
+          .AddDouble("throughput", throughput)
+          .AddDouble("avgDelay", averageDelay * 1000)
+          .AddDouble("packetLoss", packetLossRate * 100)
+          .AddUint("steadyState", steady ? 1 : 0)
+          .AddDouble("warmupEnd", warmupEnd)
+          .AddDouble("simulatedTime", simulatedTime);
+    profile.AddToRecord(record);
+    
+    if (writer.IsEnabled()) {
+        writer.Write(record);
+    } else {
+        std::cout << "\n=== 网络性能统计结果 ===" << std::endl;
+        std::cout << "仿真时间: " << simulationTime << " 秒" << std::endl;
+        std::cout << "数据包大小: " << packetSize << " 字节" << std::endl;
+        std::cout << "发送数据包总数: " << maxPackets << std::endl;
+        std::cout << "接收数据包总数: " << stats.receivedPackets << std::endl;
+        std::cout << "总接收字节数: " << stats.bytesReceived << " 字节" << std::endl;
+        std::cout << "网络吞吐量: " << throughput << " Mbps" << std::endl;
+        std::cout << "平均延迟: " << averageDelay * 1000 << " ms" << std::endl;
+        std::cout << "丢包率: " << packetLossRate * 100 << "%" << std::endl;
+        std::cout << "仿真事件数: " << events;
+        if (stats.bytesReceived > 0) {
+            std::cout << "（每KB接收数据 " << events * 1024.0 / stats.bytesReceived << " 个事件）";
+        }
+        std::cout << std::endl;
+        std::cout << "仿真开销: 墙钟时间 " << profile.wallSeconds << " 秒，每秒 "
+                  << profile.GetEventsPerSecond() << " 个事件，仿真/真实时间比 "
+                  << profile.GetSimRealRatio() << "，峰值内存 " << profile.peakRssKb
+                  << " KiB，创建数据包 " << profile.packetsCreated << " 个，首个事件前 CPU 时间 "
+                  << profile.timeToFirstEvent << " 秒" << std::endl;
+        if (config.steadyState) {
+            if (steady) {
+                std::cout << "稳态检测: 预热期截至 " << warmupEnd << " 秒，仿真在 "
+                          << simulatedTime << " 秒提前结束" << std::endl;
+            } else {
+                std::cout << "稳态检测: 未检测到稳态，按完整仿真时间统计" << std::endl;
+            }
+        }
+        std::cout << "========================\n" << std::endl;
+    }
     
+    monitor.reset();
     Simulator::Destroy();
+    return record;
+}
+
+/**
+ * @brief 以连续的 RngRun 重复运行同一配置，直到吞吐量和延迟的置信区间满足 ciTarget
+ */
+void RunReplications(const Task1Config& config, ResultWriter& writer) {
+    if (config.runs <= 1) {
+        RunExperiment(config, writer);
+        return;
+    }
+    
+    AdaptiveSweep sweep(CI_METRICS, config.ciTarget, config.minRuns, config.runs);
+    ReplicationStats replications =
+        sweep.RunPoint([&config, &writer]() { return RunExperiment(config, writer); });
+    
+    // 结构化输出时标准输出只保留每次运行的记录
+    sweep.PrintSummary(writer.IsEnabled() ? std::cerr : std::cout, replications);
+}
+
+/**
+ * @brief 主函数
+ */
+int main(int argc, char *argv[]) {
+    // 命令行参数解析
+    Task1Config config;
+    CommandLine cmd;
+    AddCommandLineOptions(cmd, config);
+    cmd.Parse(argc, argv);
+    
+    // 选择结构化输出时，标准输出只包含结果记录；批处理模式下所有运行共用一个结果流
+    ResultWriter writer(config.resultFormat, "lab3-task1", RESULT_SCHEMA_VERSION, config.resultFile);
+    
+    if (config.batchFile.empty()) {
+        RunReplications(config, writer);
+        return 0;
+    }
+    
+    BatchRunner batch(argc, argv);
+    batch.Run(config.batchFile, [&writer](const std::vector<std::string>& args) {
+        Task1Config lineConfig;
+        CommandLine lineCmd;
+        AddCommandLineOptions(lineCmd, lineConfig);
+        lineCmd.Parse(args);
+        RunReplications(lineConfig, writer);
+    });
     return 0;
 }
 
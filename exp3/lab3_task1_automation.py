@@ -15,7 +15,16 @@ from datetime import datetime
 import os
 import sys
 import argparse
-import re
+import tempfile
+
+# run_simulation 参数名到 lab3_task1 命令行选项的映射
+OPTION_NAMES = {
+    'packet_size': 'packetSize',
+    'max_packets': 'maxPackets',
+    'simulation_time': 'simulationTime',
+    'data_rate': 'dataRate',
+    'delay': 'delay',
+}
 
 class NetworkTestAutomation:
     def __init__(self, output_dir="results"):
@@ -45,7 +54,8 @@ class NetworkTestAutomation:
             f'--maxPackets={max_packets}',
             f'--simulationTime={simulation_time}',
             f'--dataRate={data_rate}',
-            f'--delay={delay}'
+            f'--delay={delay}',
+            '--resultFormat=jsonl'
         ]
         
         print(f"运行测试: 数据包大小={packet_size}B, 最大包数={max_packets}, 数据率={data_rate}, 延迟={delay}")
@@ -60,32 +70,16 @@ class NetworkTestAutomation:
                 print(f"  错误输出: {result.stderr}")
                 return None
             
-            # 调试：打印原始输出
-            print(f"  原始输出前500字符: {result.stdout[:500]}")
-            
-            # 解析输出结果
-            throughput = self.parse_throughput(result.stdout)
-            avg_delay = self.parse_delay(result.stdout)
-            packet_loss = self.parse_packet_loss(result.stdout)
-            received_packets = self.parse_received_packets(result.stdout)
-            total_bytes = self.parse_total_bytes(result.stdout)
-            
-            test_result = {
-                'packet_size': packet_size,
-                'max_packets': max_packets,
-                'simulation_time': simulation_time,
-                'data_rate': data_rate,
-                'delay': delay,
-                'throughput': throughput,
-                'avg_delay': avg_delay,
-                'packet_loss': packet_loss,
-                'received_packets': received_packets,
-                'total_bytes': total_bytes,
-                'timestamp': datetime.now().isoformat()
-            }
+            # 解析结构化结果记录（每次运行一条JSON记录）
+            record = self.parse_record(result.stdout)
+            if record is None:
+                print(f"  错误: 输出中没有结果记录")
+                return None
             
+            test_result = self.record_to_result(record)
             self.results.append(test_result)
-            print(f"  解析结果: 吞吐量={throughput:.4f}Mbps, 延迟={avg_delay:.2f}ms, 丢包率={packet_loss:.1f}%")
+            print(f"  解析结果: 吞吐量={test_result['throughput']:.4f}Mbps, "
+                  f"延迟={test_result['avg_delay']:.2f}ms, 丢包率={test_result['packet_loss']:.1f}%")
             
             return test_result
             
@@ -95,78 +89,94 @@ class NetworkTestAutomation:
             traceback.print_exc()
             return None
     
-    def parse_throughput(self, output):
-        """从输出中解析吞吐量"""
-        for line in output.split('\n'):
-            if '网络吞吐量:' in line:
-                # 提取数字部分
-                match = re.search(r'[\d.]+', line.split(':')[1])
-                if match:
-                    return float(match.group())
-        return 0.0
-    
-    def parse_delay(self, output):
-        """从输出中解析平均延迟"""
-        for line in output.split('\n'):
-            if '平均延迟:' in line:
-                # 提取数字部分
-                match = re.search(r'[\d.]+', line.split(':')[1])
-                if match:
-                    return float(match.group())
-        return 0.0
+    def run_batch(self, cases):
+        """在同一个进程中运行多组参数（--batch 模式），只启动一次 ns-3"""
+        fd, batch_file = tempfile.mkstemp(suffix='.batch', prefix='lab3_task1_')
+        with os.fdopen(fd, 'w') as f:
+            for case in cases:
+                f.write(' '.join(f'--{OPTION_NAMES[k]}={v}' for k, v in case.items()) + '\n')
+        
+        cmd = [
+            './ns3', 'run',
+            'scratch/exp3/lab3_task1',
+            '--',
+            f'--batch={os.path.abspath(batch_file)}',
+            '--resultFormat=jsonl'
+        ]
+        
+        print(f"批量运行 {len(cases)} 组测试")
+        try:
+            result = subprocess.run(cmd, capture_output=True, text=True, cwd='.')
+        finally:
+            os.remove(batch_file)
+        
+        if result.returncode != 0:
+            print(f"  错误: 批量仿真运行失败，返回码: {result.returncode}")
+            print(f"  错误输出: {result.stderr}")
+            return []
+        
+        batch_results = []
+        for record in self.parse_records(result.stdout):
+            test_result = self.record_to_result(record)
+            self.results.append(test_result)
+            batch_results.append(test_result)
+            print(f"  {test_result['packet_size']}B/{test_result['data_rate']}/{test_result['delay']}: "
+                  f"吞吐量={test_result['throughput']:.4f}Mbps, 延迟={test_result['avg_delay']:.2f}ms, "
+                  f"丢包率={test_result['packet_loss']:.1f}%")
+        return batch_results
     
-    def parse_packet_loss(self, output):
-        """从输出中解析丢包率 - 修复百分号处理"""
-        for line in output.split('\n'):
-            if '丢包率:' in line:
-                # 提取数字部分，去掉百分号
-                value_str = line.split(':')[1].strip()
-                # 使用正则表达式提取数字
-                match = re.search(r'([\d.]+)', value_str)
-                if match:
-                    return float(match.group(1))
-        return 0.0
+    def record_to_result(self, record):
+        """把 lab3-task1 结果记录转换为测试结果字典"""
+        return {
+            'packet_size': record['packetSize'],
+            'max_packets': record['maxPackets'],
+            'simulation_time': record['simulationTime'],
+            'data_rate': record['dataRate'],
+            'delay': record['delay'],
+            'throughput': record['throughput'],
+            'avg_delay': record['avgDelay'],
+            'packet_loss': record['packetLoss'],
+            'received_packets': record['receivedPackets'],
+            'total_bytes': record['bytesReceived'],
+            'timestamp': datetime.now().isoformat()
+        }
     
-    def parse_received_packets(self, output):
-        """从输出中解析接收数据包数"""
+    def parse_records(self, output):
+        """读取输出中所有的 lab3-task1 结果记录"""
+        records = []
         for line in output.split('\n'):
-            if '接收数据包总数:' in line:
-                # 提取数字部分
-                match = re.search(r'\d+', line.split(':')[1])
-                if match:
-                    return int(match.group())
-        return 0
+            if line.startswith('{'):
+                record = json.loads(line)
+                if record.get('schema') == 'lab3-task1':
+                    records.append(record)
+        return records
     
-    def parse_total_bytes(self, output):
-        """从输出中解析总接收字节数"""
+    def parse_record(self, output):
+        """读取输出中的 lab3-task1 结果记录"""
         for line in output.split('\n'):
-            if '总接收字节数:' in line:
-                # 提取数字部分
-                match = re.search(r'\d+', line.split(':')[1])
-                if match:
-                    return int(match.group())
-        return 0
+            if line.startswith('{'):
+                record = json.loads(line)
+                if record.get('schema') == 'lab3-task1':
+                    return record
+        return None
     
     def test_packet_sizes(self):
         """测试不同数据包大小对性能的影响"""
         print("\n=== 测试不同数据包大小 ===")
         packet_sizes = [512, 1024, 2048]
-        for size in packet_sizes:
-            self.run_simulation(packet_size=size, max_packets=100)
+        self.run_batch([{'packet_size': size, 'max_packets': 100} for size in packet_sizes])
     
     def test_data_rates(self):
         """测试不同数据速率对性能的影响"""
         print("\n=== 测试不同数据速率 ===")
         data_rates = ["1Mbps", "5Mbps", "10Mbps"]
-        for rate in data_rates:
-            self.run_simulation(data_rate=rate)
+        self.run_batch([{'data_rate': rate} for rate in data_rates])
     
     def test_delays(self):
         """测试不同链路延迟对性能的影响"""
         print("\n=== 测试不同链路延迟 ===")
         delays = ["2ms", "10ms", "50ms"]
-        for delay in delays:
-            self.run_simulation(delay=delay)
+        self.run_batch([{'delay': delay} for delay in delays])
     
     def run_basic_test(self):
         """基础测试 - 只运行最基本的测试"""
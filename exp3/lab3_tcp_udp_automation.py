@@ -13,7 +13,6 @@ from datetime import datetime
 import os
 import sys
 import argparse
-import re
 
 class TcpUdpComparisonAutomation:
     def __init__(self, output_dir="results_tcp_udp"):
@@ -42,7 +41,8 @@ class TcpUdpComparisonAutomation:
             f'--errorRate={error_rate}',
             f'--tcpAlgorithm={tcp_algorithm}',
             f'--packetSize={packet_size}',
-            f'--simulationTime={simulation_time}'
+            f'--simulationTime={simulation_time}',
+            '--resultFormat=jsonl'
         ]
         
         print(f"运行测试场景: {scenario_name}")
@@ -59,9 +59,7 @@ class TcpUdpComparisonAutomation:
                 return None
             
             # 解析输出结果
-            parsed_results = self.parse_output(result.stdout, scenario_name, 
-                                             data_rate, delay, error_rate, 
-                                             tcp_algorithm, packet_size)
+            parsed_results = self.parse_records(result.stdout, scenario_name)
             
             if parsed_results:
                 self.results.extend(parsed_results)
@@ -75,73 +73,65 @@ class TcpUdpComparisonAutomation:
             traceback.print_exc()
             return None
     
-    def parse_output(self, output, scenario_name, data_rate, delay, error_rate, tcp_algorithm, packet_size):
-        """从输出中解析性能统计结果"""
+    def parse_records(self, output, scenario_name):
+        """从结构化结果记录（JSON Lines）中读取各协议的性能统计"""
         results = []
         
-        # 查找性能统计结果部分
-        lines = output.split('\n')
-        in_results_section = False
-        protocol_data = {}
-        
-        for line in lines:
-            if '性能统计结果:' in line:
-                in_results_section = True
+        for line in output.split('\n'):
+            if not line.startswith('{'):
                 continue
-            
-            if in_results_section:
-                if line.strip() == '':
-                    continue
-                
-                # 解析协议行 - 修复解析逻辑
-                if '\t' in line and not line.startswith('协议'):
-                    parts = line.split('\t')
-                    if len(parts) >= 4:
-                        protocol = parts[0].strip()
-                        
-                        # 安全地解析数值，处理可能的空值
-                        try:
-                            throughput = float(parts[1].strip()) if parts[1].strip() else 0.0
-                        except ValueError:
-                            throughput = 0.0
-                        
-                        try:
-                            avg_delay = float(parts[2].strip()) if parts[2].strip() else 0.0
-                        except ValueError:
-                            avg_delay = 0.0
-                        
-                        try:
-                            packet_loss = float(parts[3].strip()) if parts[3].strip() else 0.0
-                        except ValueError:
-                            packet_loss = 0.0
-                        
-                        result = {
-                            'scenario_name': scenario_name,
-                            'protocol': protocol,
-                            'data_rate': data_rate,
-                            'delay': delay,
-                            'error_rate': error_rate,
-                            'tcp_algorithm': tcp_algorithm,
-                            'packet_size': packet_size,
-                            'throughput': throughput,
-                            'avg_delay': avg_delay,
-                            'packet_loss': packet_loss,
-                            'timestamp': datetime.now().isoformat()
-                        }
-                        results.append(result)
-                
-                # 查找公平性指数
-                if '公平性指数:' in line:
-                    match = re.search(r'[\d.]+', line.split(':')[1])
-                    if match:
-                        fairness_index = float(match.group())
-                        # 为所有结果添加公平性指数
-                        for result in results:
-                            result['fairness_index'] = fairness_index
-                    in_results_section = False
+            record = json.loads(line)
+            if record.get('schema') != 'lab3-tcp-udp-comparison':
+                continue
+            results.extend(self.record_to_results(record, scenario_name))
         
         return results
     
+    def record_to_results(self, record, scenario_name):
+        """将一条场景记录拆分为TCP和UDP两个结果"""
+        results = []
+        for protocol in ('TCP', 'UDP'):
+            prefix = protocol.lower()
+            results.append({
+                'scenario_name': scenario_name,
+                'protocol': protocol,
+                'data_rate': record['dataRate'],
+                'delay': record['delay'],
+                'error_rate': record['errorRate'],
+                'tcp_algorithm': record['tcpAlgorithm'],
+                'packet_size': record['packetSize'],
+                'run': record['run'],
+                'throughput': record[f'{prefix}Throughput'],
+                'avg_delay': record[f'{prefix}AvgDelay'],
+                'packet_loss': record[f'{prefix}PacketLoss'],
+                'fairness_index': record['fairnessIndex'],
+                'timestamp': datetime.now().isoformat()
+            })
+        return results
+    
+    def run_matrix(self, matrix_file, workers=0):
+        """通过场景矩阵文件一次性运行全部组合（单进程启动，以 --resultFormat=jsonl 逐行读取JSON记录）"""
+        cmd = [
+            './cmake-cache/scratch/exp3/ns3.46-lab3_tcp_udp_comparison-default',
+            f'--scenarios={matrix_file}',
+            f'--workers={workers}',
+            '--resultFormat=jsonl'
+        ]
+        
+        print(f"运行场景矩阵: {matrix_file}")
+        
+        process = subprocess.Popen(cmd, stdout=subprocess.PIPE, text=True, cwd='.')
+        count = 0
+        for line in process.stdout:
+            record = json.loads(line)
+            self.results.extend(self.record_to_results(record, record['scenario']))
+            count += 1
+        
+        if process.wait() != 0:
+            print(f"  错误: 仿真运行失败，返回码: {process.returncode}")
+        print(f"  矩阵运行完成: 收集到 {count} 次运行结果")
+        return count
+    
     def test_ideal_conditions(self):
         """测试理想网络条件"""
         print("\n=== Testing Ideal Network Conditions ===")
@@ -457,6 +447,8 @@ def main():
     parser.add_argument('--mode', choices=['basic', 'comprehensive'], 
                        default='comprehensive', help='测试模式: basic(基础), comprehensive(全面)')
     parser.add_argument('--output', default='results_tcp_udp', help='输出目录')
+    parser.add_argument('--matrix', help='场景矩阵文件（设置后忽略 --mode，直接运行矩阵）')
+    parser.add_argument('--workers', type=int, default=0, help='矩阵模式下的并行工作进程数（0表示每个CPU一个）')
     
     args = parser.parse_args()
     
@@ -466,7 +458,10 @@ def main():
     print(f"测试模式: {args.mode}")
     print(f"输出目录: {args.output}")
     
-    if args.mode == 'comprehensive':
+    if args.matrix:
+        automation.run_matrix(args.matrix, args.workers)
+        automation.save_results()
+    elif args.mode == 'comprehensive':
         automation.run_comprehensive_tests()
     else:
         # 基础测试只运行几个关键场景
@@ -15,31 +15,180 @@
 #include "ns3/applications-module.h"
 #include "ns3/flow-monitor-module.h"
 #include "ns3/error-model.h"
+#ifdef NS3_MPI
+#include "ns3/mpi-interface.h"
+#include <mpi.h>
+#endif
+#include "../common/error-model-factory.h"
+#include "../common/flow-aggregator.h"
+#include "../common/flow-stats-sampler.h"
+#include "../common/fluid-link-model.h"
+#include "../common/fork-worker-pool.h"
+#include "../common/hot-path-log.h"
+#include "../common/latency-histogram.h"
+#include "../common/result-writer.h"
+#include "../common/scenario-matrix.h"
+#include "../common/scheduler-type.h"
+#include "../common/send-time-tag.h"
+#include "../common/simulation-profiler.h"
+#include "../common/work-stealing-pool.h"
 #include <iostream>
 #include <fstream>
 #include <vector>
 #include <map>
+#include <memory>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
 
 using namespace ns3;
 
 NS_LOG_COMPONENT_DEFINE("TcpUdpComparison");
 
-// 全局统计结构
-struct ProtocolStats {
+// 单个服务器应用的计数块，按缓存行对齐，避免相邻应用的计数器共享缓存行
+struct alignas(64) ProtocolStats {
     uint64_t totalBytesReceived;
     uint64_t totalPacketsReceived;
     double totalDelay;
     uint64_t totalPacketsSent;
     double startTime;
     double stopTime;
+    uint64_t delaySamples;      // totalDelay 累加的样本权重（UDP 为数据报数，TCP 为字节数）
     
     ProtocolStats() : totalBytesReceived(0), totalPacketsReceived(0), 
                      totalDelay(0.0), totalPacketsSent(0), 
-                     startTime(0.0), stopTime(0.0) {}
+                     startTime(0.0), stopTime(0.0), delaySamples(0) {}
 };
 
-// 全局统计变量
-std::map<std::string, ProtocolStats> protocolStats;
+/**
+ * @brief 统计槽表
+ *
+ * 每个服务器应用在安装时登记一个槽位，在 StartApplication 时绑定槽位中计数块的指针，
+ * 之后接收路径只做指针上的计数累加。协议名、流编号等登记信息只在报告时读取。
+ * 槽位数在每次运行开始时固定，运行期间不会重新分配，因此已绑定的指针始终有效。
+ */
+class StatsTable {
+public:
+    /**
+     * @brief 清空槽表并分配固定数量的槽位
+     */
+    void Reset(uint32_t capacity) {
+        m_slots.assign(capacity, ProtocolStats());
+        m_entries.clear();
+        m_entries.reserve(capacity);
+        m_latency.clear();
+    }
+    
+    /**
+     * @brief 登记一个流，返回槽位编号（安装应用时调用）
+     */
+    uint32_t Register(const std::string& protocol, uint32_t flow,
+                      Ipv4Address address, uint16_t port) {
+        if (m_entries.size() >= m_slots.size()) {
+            NS_FATAL_ERROR("Stats table full (" << m_slots.size() << " slots)");
+        }
+        m_entries.push_back(Entry{protocol, flow, address, port});
+        m_latency[protocol];    // 每个协议一个时延直方图，登记时创建
+        return m_entries.size() - 1;
+    }
+    
+    /**
+     * @brief 获取槽位的计数块（StartApplication 时绑定）
+     */
+    ProtocolStats* GetSlot(uint32_t slot) {
+        NS_ASSERT(slot < m_entries.size());
+        return &m_slots[slot];
+    }
+    
+    uint32_t GetSize() const { return m_entries.size(); }
+    const std::string& GetProtocol(uint32_t slot) const { return m_entries[slot].protocol; }
+    uint32_t GetFlow(uint32_t slot) const { return m_entries[slot].flow; }
+    Ipv4Address GetAddress(uint32_t slot) const { return m_entries[slot].address; }
+    uint16_t GetPort(uint32_t slot) const { return m_entries[slot].port; }
+    const ProtocolStats& GetStats(uint32_t slot) const { return m_slots[slot]; }
+    
+    /**
+     * @brief 获取槽位所属协议的时延直方图（StartApplication 时绑定，同协议的流共用）
+     */
+    LatencyHistogram* GetLatencyHistogram(uint32_t slot) {
+        return &m_latency[m_entries[slot].protocol];
+    }
+    
+    const std::map<std::string, LatencyHistogram>& GetLatencyHistograms() const { return m_latency; }
+    
+    /**
+     * @brief 清零所有计数和时延直方图，保留登记信息和已绑定的指针（检查点之后从 now 开始统计）
+     */
+    void ClearCounters(double now) {
+        for (ProtocolStats& stats : m_slots) {
+            stats = ProtocolStats();
+            stats.startTime = now;
+        }
+        for (auto& histogram : m_latency) {
+            histogram.second.Reset();
+        }
+    }
+
+private:
+    struct Entry {
+        std::string protocol;
+        uint32_t flow;
+        Ipv4Address address;
+        uint16_t port;
+    };
+    
+    std::vector<ProtocolStats> m_slots;
+    std::vector<Entry> m_entries;
+    std::map<std::string, LatencyHistogram> m_latency;
+};
+
+/**
+ * @brief 记录单向时延：累加到流的计数块，并计入协议的时延直方图
+ *
+ * weight 为样本权重：UDP 每个数据报记 1，TCP 按字节数加权（见 TcpStatsServer::HandleRead）。
+ */
+void RecordDelay(ProtocolStats* stats, LatencyHistogram* histogram, Time delay, uint64_t weight = 1) {
+    stats->totalDelay += delay.GetSeconds() * weight;
+    stats->delaySamples += weight;
+    histogram->Record(delay.GetNanoSeconds(), weight);
+}
+
+/**
+ * @brief 分布式仿真的进程划分（未启用MPI时只有一个进程，所有节点都在本地）
+ */
+struct Partition {
+    uint32_t systemId;
+    uint32_t systemCount;
+};
+
+Partition partition = {0, 1};
+
+/**
+ * @brief 节点是否由本进程仿真（只在本地节点上安装应用）
+ */
+bool IsLocal(Ptr<Node> node) {
+    return node->GetSystemId() == partition.systemId;
+}
+
+/**
+ * @brief 哑铃拓扑左侧第i个节点所在进程：左侧占用前一半进程
+ */
+uint32_t LeftRank(uint32_t i) {
+    uint32_t half = std::max(1u, partition.systemCount / 2);
+    return i % half;
+}
+
+/**
+ * @brief 哑铃拓扑右侧第i个节点所在进程：右侧占用后一半进程
+ */
+uint32_t RightRank(uint32_t i) {
+    if (partition.systemCount < 2) {
+        return 0;
+    }
+    uint32_t half = partition.systemCount / 2;
+    return half + i % (partition.systemCount - half);
+}
 
 /**
  * @brief TCP 服务器应用，用于统计TCP性能
@@ -51,7 +200,7 @@ public:
 
     static TypeId GetTypeId(void);
     
-    void Setup(uint16_t port);
+    void Setup(uint16_t port, StatsTable* table, uint32_t slot);
 
 protected:
     virtual void DoDispose(void);
@@ -64,11 +213,16 @@ private:
     void HandleRead(Ptr<Socket> socket);
     
     uint16_t m_port;
+    StatsTable* m_table;            // 本次运行的统计槽表
+    uint32_t m_slot;                // 统计槽位编号
+    ProtocolStats* m_stats;         // StartApplication 时绑定的计数块
+    LatencyHistogram* m_latency;    // StartApplication 时绑定的时延直方图
     Ptr<Socket> m_socket;
     std::vector<Ptr<Socket>> m_connections;
 };
 
-TcpStatsServer::TcpStatsServer() : m_port(0) {
+TcpStatsServer::TcpStatsServer()
+    : m_port(0), m_table(nullptr), m_slot(0), m_stats(nullptr), m_latency(nullptr) {
 }
 
 TcpStatsServer::~TcpStatsServer() {
@@ -82,8 +236,10 @@ TypeId TcpStatsServer::GetTypeId(void) {
     return tid;
 }
 
-void TcpStatsServer::Setup(uint16_t port) {
+void TcpStatsServer::Setup(uint16_t port, StatsTable* table, uint32_t slot) {
     m_port = port;
+    m_table = table;
+    m_slot = slot;
 }
 
 void TcpStatsServer::DoDispose(void) {
@@ -115,7 +271,9 @@ void TcpStatsServer::StartApplication(void) {
         );
     }
     
-    protocolStats["TCP"].startTime = Simulator::Now().GetSeconds();
+    m_stats = m_table->GetSlot(m_slot);
+    m_latency = m_table->GetLatencyHistogram(m_slot);
+    m_stats->startTime = Simulator::Now().GetSeconds();
     NS_LOG_INFO("TCP Server started on port " << m_port);
 }
 
@@ -135,7 +293,7 @@ void TcpStatsServer::StopApplication(void) {
     }
     m_connections.clear();
     
-    protocolStats["TCP"].stopTime = Simulator::Now().GetSeconds();
+    m_stats->stopTime = Simulator::Now().GetSeconds();
 }
 
 void TcpStatsServer::HandleAccept(Ptr<Socket> socket, const Address& from) {
@@ -153,15 +311,36 @@ void TcpStatsServer::HandleRead(Ptr<Socket> socket) {
     while ((packet = socket->RecvFrom(from))) {
         uint32_t packetSize = packet->GetSize();
         
-        // 更新TCP统计
-        protocolStats["TCP"].totalBytesReceived += packetSize;
-        protocolStats["TCP"].totalPacketsReceived++;
+        // 应用层单向时延（写入发送端套接字到读出）：TCP重新分段、重组后，每段字节仍带着
+        // 发送端写入时的 SendTimeTag。一次写入的字节可能分几次读出，一次读出也可能包含
+        // 多次写入的字节，因此按标签范围的字节数加权，每个字节恰好计一次，与读的次数无关。
+        // 发送端一直写满发送缓冲区，所以时延包含发送缓冲区中的排队时间。
+        // 统计开始（检查点）之前写入的字节不计入接收量和时延，它们的发送不在统计区间内。
+        Time now = Simulator::Now();
+        Time start = Seconds(m_stats->startTime);
+        uint32_t received = packetSize;
+        ByteTagIterator tags = packet->GetByteTagIterator();
+        while (tags.HasNext()) {
+            ByteTagIterator::Item item = tags.Next();
+            if (item.GetTypeId() != SendTimeTag::GetTypeId()) {
+                continue;
+            }
+            SendTimeTag tag;
+            item.GetTag(tag);
+            if (tag.GetSendTime() < start) {
+                received -= item.GetEnd() - item.GetStart();
+                continue;
+            }
+            RecordDelay(m_stats, m_latency, now - tag.GetSendTime(), item.GetEnd() - item.GetStart());
+        }
         
-        // 计算延迟（简化版本，实际TCP需要更复杂的延迟计算）
-        double receiveTime = Simulator::Now().GetSeconds();
-        protocolStats["TCP"].totalDelay += receiveTime - protocolStats["TCP"].startTime;
+        // 更新TCP统计
+        if (received > 0) {
+            m_stats->totalBytesReceived += received;
+            m_stats->totalPacketsReceived++;
+        }
         
-        NS_LOG_DEBUG("TCP Packet received, size: " << packetSize << " bytes");
+        HOT_PATH_LOG_DEBUG("TCP Packet received, size: " << packetSize << " bytes");
     }
 }
 
@@ -175,7 +354,7 @@ public:
 
     static TypeId GetTypeId(void);
     
-    void Setup(uint16_t port);
+    void Setup(uint16_t port, StatsTable* table, uint32_t slot);
 
 protected:
     virtual void DoDispose(void);
@@ -187,10 +366,15 @@ private:
     void HandleRead(Ptr<Socket> socket);
     
     uint16_t m_port;
+    StatsTable* m_table;            // 本次运行的统计槽表
+    uint32_t m_slot;                // 统计槽位编号
+    ProtocolStats* m_stats;         // StartApplication 时绑定的计数块
+    LatencyHistogram* m_latency;    // StartApplication 时绑定的时延直方图
     Ptr<Socket> m_socket;
 };
 
-UdpStatsServer::UdpStatsServer() : m_port(0) {
+UdpStatsServer::UdpStatsServer()
+    : m_port(0), m_table(nullptr), m_slot(0), m_stats(nullptr), m_latency(nullptr) {
 }
 
 UdpStatsServer::~UdpStatsServer() {
@@ -204,8 +388,10 @@ TypeId UdpStatsServer::GetTypeId(void) {
     return tid;
 }
 
-void UdpStatsServer::Setup(uint16_t port) {
+void UdpStatsServer::Setup(uint16_t port, StatsTable* table, uint32_t slot) {
     m_port = port;
+    m_table = table;
+    m_slot = slot;
 }
 
 void UdpStatsServer::DoDispose(void) {
@@ -230,7 +416,9 @@ void UdpStatsServer::StartApplication(void) {
     }
     
     m_socket->SetRecvCallback(MakeCallback(&UdpStatsServer::HandleRead, this));
-    protocolStats["UDP"].startTime = Simulator::Now().GetSeconds();
+    m_stats = m_table->GetSlot(m_slot);
+    m_latency = m_table->GetLatencyHistogram(m_slot);
+    m_stats->startTime = Simulator::Now().GetSeconds();
     NS_LOG_INFO("UDP Server started on port " << m_port);
 }
 
@@ -241,7 +429,7 @@ void UdpStatsServer::StopApplication(void) {
         m_socket->SetRecvCallback(MakeNullCallback<void, Ptr<Socket>>());
     }
     
-    protocolStats["UDP"].stopTime = Simulator::Now().GetSeconds();
+    m_stats->stopTime = Simulator::Now().GetSeconds();
 }
 
 void UdpStatsServer::HandleRead(Ptr<Socket> socket) {
@@ -253,25 +441,183 @@ void UdpStatsServer::HandleRead(Ptr<Socket> socket) {
     while ((packet = socket->RecvFrom(from))) {
         uint32_t packetSize = packet->GetSize();
         
-        // 更新UDP统计
-        protocolStats["UDP"].totalBytesReceived += packetSize;
-        protocolStats["UDP"].totalPacketsReceived++;
+        // 单向时延：OnOff 客户端在每个数据报前加 SeqTsSizeHeader，记录发送时间。
+        // 统计开始（检查点）之前发出的数据报不计入：其发送计数已清零，计入会使接收数超过发送数
+        SeqTsSizeHeader header;
+        if (packetSize >= header.GetSerializedSize()) {
+            packet->PeekHeader(header);
+            if (header.GetTs() < Seconds(m_stats->startTime)) {
+                continue;
+            }
+            RecordDelay(m_stats, m_latency, Simulator::Now() - header.GetTs());
+        }
         
-        // 计算延迟（简化版本）
-        double receiveTime = Simulator::Now().GetSeconds();
-        protocolStats["UDP"].totalDelay += receiveTime - protocolStats["UDP"].startTime;
+        // 更新UDP统计
+        m_stats->totalBytesReceived += packetSize;
+        m_stats->totalPacketsReceived++;
         
-        NS_LOG_DEBUG("UDP Packet received, size: " << packetSize << " bytes");
+        HOT_PATH_LOG_DEBUG("UDP Packet received, size: " << packetSize << " bytes");
+    }
+}
+
+/**
+ * @brief 带发送时间标签的TCP批量发送应用
+ *
+ * 行为与 BulkSendApplication（MaxBytes=0）相同：连接建立后不断写满发送缓冲区，
+ * 缓冲区腾出空间后继续写入。不同的是每次写入的数据都带有 SendTimeTag 字节标签，
+ * 接收端可以按字节范围计算真实的单向时延。
+ */
+class TimestampedBulkSend : public Application {
+public:
+    TimestampedBulkSend();
+    virtual ~TimestampedBulkSend();
+
+    static TypeId GetTypeId(void);
+    
+    void Setup(const Address& remote, uint32_t sendSize);
+
+protected:
+    virtual void DoDispose(void);
+
+private:
+    virtual void StartApplication(void);
+    virtual void StopApplication(void);
+    
+    void SendData(void);
+    void ConnectionSucceeded(Ptr<Socket> socket);
+    void ConnectionFailed(Ptr<Socket> socket);
+    void DataSend(Ptr<Socket> socket, uint32_t available);
+    
+    Address m_remote;
+    uint32_t m_sendSize;
+    Ptr<Socket> m_socket;
+    bool m_connected;
+    TracedCallback<Ptr<const Packet>> m_txTrace;
+};
+
+TimestampedBulkSend::TimestampedBulkSend() : m_sendSize(512), m_connected(false) {
+}
+
+TimestampedBulkSend::~TimestampedBulkSend() {
+}
+
+TypeId TimestampedBulkSend::GetTypeId(void) {
+    static TypeId tid = TypeId("TimestampedBulkSend")
+        .SetParent<Application>()
+        .SetGroupName("Applications")
+        .AddConstructor<TimestampedBulkSend>()
+        .AddTraceSource("Tx", "A new packet was written to the socket",
+                        MakeTraceSourceAccessor(&TimestampedBulkSend::m_txTrace),
+                        "ns3::Packet::TracedCallback");
+    return tid;
+}
+
+void TimestampedBulkSend::Setup(const Address& remote, uint32_t sendSize) {
+    m_remote = remote;
+    m_sendSize = sendSize;
+}
+
+void TimestampedBulkSend::DoDispose(void) {
+    NS_LOG_FUNCTION(this);
+    m_socket = 0;
+    Application::DoDispose();
+}
+
+void TimestampedBulkSend::StartApplication(void) {
+    NS_LOG_FUNCTION(this);
+    
+    if (!m_socket) {
+        m_socket = Socket::CreateSocket(GetNode(), TcpSocketFactory::GetTypeId());
+        if (m_socket->Bind() == -1) {
+            NS_FATAL_ERROR("Failed to bind socket");
+        }
+        m_socket->Connect(m_remote);
+        m_socket->ShutdownRecv();
+        m_socket->SetConnectCallback(
+            MakeCallback(&TimestampedBulkSend::ConnectionSucceeded, this),
+            MakeCallback(&TimestampedBulkSend::ConnectionFailed, this));
+        m_socket->SetSendCallback(MakeCallback(&TimestampedBulkSend::DataSend, this));
+    }
+    if (m_connected) {
+        SendData();
+    }
+}
+
+void TimestampedBulkSend::StopApplication(void) {
+    NS_LOG_FUNCTION(this);
+    
+    if (m_socket) {
+        m_socket->Close();
+        m_connected = false;
+    }
+}
+
+void TimestampedBulkSend::SendData(void) {
+    NS_LOG_FUNCTION(this);
+    
+    // 一直写到发送缓冲区满（Send 返回 -1），等 DataSend 回调再继续
+    while (true) {
+        Ptr<Packet> packet = Create<Packet>(m_sendSize);
+        packet->AddByteTag(SendTimeTag(Simulator::Now()));
+        int actual = m_socket->Send(packet);
+        if (actual != static_cast<int>(m_sendSize)) {
+            break;
+        }
+        m_txTrace(packet);
+    }
+}
+
+void TimestampedBulkSend::ConnectionSucceeded(Ptr<Socket> socket) {
+    NS_LOG_FUNCTION(this << socket);
+    m_connected = true;
+    SendData();
+}
+
+void TimestampedBulkSend::ConnectionFailed(Ptr<Socket> socket) {
+    NS_LOG_FUNCTION(this << socket);
+    NS_LOG_WARN("TimestampedBulkSend connection failed");
+}
+
+void TimestampedBulkSend::DataSend(Ptr<Socket> socket, uint32_t available) {
+    NS_LOG_FUNCTION(this << socket << available);
+    if (m_connected) {
+        SendData();
     }
 }
 
+// 服务器端口；p2p拓扑下所有流共用一对节点，第i个流使用 BASE_PORT + 2*i
+const uint16_t TCP_BASE_PORT = 5000;
+const uint16_t UDP_BASE_PORT = 5001;
+
+// 哑铃拓扑接入链路参数（远大于瓶颈链路，使瓶颈链路成为唯一的竞争点）
+const char* const ACCESS_DATA_RATE = "1Gbps";
+const char* const ACCESS_DELAY = "1ms";
+
+/**
+ * @brief 网络拓扑：第i个流的发送节点、接收节点和接收端地址
+ */
+struct Topology {
+    std::vector<Ptr<Node>> clients;
+    std::vector<Ptr<Node>> servers;
+    std::vector<Ipv4Address> serverAddresses;
+    bool sharedNodes;           // 所有流共用同一对节点，需按流区分端口
+    NetDeviceContainer bottleneckDevices;   // 瓶颈链路（p2p为唯一链路）两端的设备，错误模型装在这里
+    bool perDeviceErrorModel;               // bottleneckDevices 每端一个独立的错误模型
+};
+
+// 链路错误模型使用的第一个随机数流编号；固定流编号后每个方向的丢包序列只取决于RngRun
+const int64_t ERROR_MODEL_STREAM = 0;
+
 /**
  * @brief 创建并配置网络拓扑
+ *
+ * perDeviceErrorModel 为 true 时每端一个独立模型和随机数流，一个方向的流量变化不影响
+ * 另一方向的丢包；为 false 时链路两端共用一个错误模型（两个方向共享随机数流和突发状态）。
  */
 void SetupNetwork(NodeContainer& nodes, NetDeviceContainer& devices, 
                   Ipv4InterfaceContainer& interfaces,
                   const std::string& dataRate, const std::string& delay,
-                  double errorRate = 0.0) {
+                  const ErrorModelFactory& errorModels, bool perDeviceErrorModel) {
     
     // 创建点对点链路
     PointToPointHelper pointToPoint;
@@ -281,16 +627,13 @@ void SetupNetwork(NodeContainer& nodes, NetDeviceContainer& devices,
     devices = pointToPoint.Install(nodes);
     
     // 如果设置了错误率，添加错误模型
-    if (errorRate > 0.0) {
-        Ptr<RateErrorModel> em = CreateObject<RateErrorModel>();
-        em->SetAttribute("ErrorRate", DoubleValue(errorRate));
-        em->SetAttribute("ErrorUnit", StringValue("ERROR_UNIT_PACKET"));
-        devices.Get(0)->SetAttribute("ReceiveErrorModel", PointerValue(em));
-        devices.Get(1)->SetAttribute("ReceiveErrorModel", PointerValue(em));
+    if (errorModels.IsEnabled()) {
+        errorModels.Install(devices, perDeviceErrorModel, ERROR_MODEL_STREAM);
     }
     
-    // 安装协议栈
+    // 安装协议栈（只分配IPv4地址，不安装IPv6）
     InternetStackHelper stack;
+    stack.SetIpv6StackInstall(false);
     stack.Install(nodes);
     
     // 分配IP地址
@@ -300,224 +643,1638 @@ void SetupNetwork(NodeContainer& nodes, NetDeviceContainer& devices,
 }
 
 /**
- * @brief 设置TCP拥塞控制算法
+ * @brief 创建哑铃拓扑：flows 对叶子节点经两台路由器间的共享瓶颈链路通信
+ *
+ * 拓扑逐条链路手工搭建（不使用 PointToPointDumbbellHelper），每个节点按 LeftRank/RightRank
+ * 指定所在进程：瓶颈链路是左右两侧之间的分区边界，超过两个进程时接入链路也会跨进程。
+ * 左侧叶子网段位于 10.0.0.0/9，右侧位于 10.128.0.0/9，每条接入链路一个 /30 网段；
+ * 路由为静态路由：叶子节点默认路由指向本侧路由器，路由器把对侧 /9 网段指向瓶颈链路，
+ * 因此建立路由的开销与流数成线性关系。
+ * 瓶颈链路两端总是各用一个独立的错误模型：两端分属不同进程时，每个方向的随机数序列
+ * 仍与单进程运行一致。
  */
-void SetTcpCongestionControl(const std::string& algorithm) {
-    if (algorithm == "NewReno") {
-        Config::SetDefault("ns3::TcpL4Protocol::SocketType", TypeIdValue(TcpNewReno::GetTypeId()));
-    } else if (algorithm == "Cubic") {
-        Config::SetDefault("ns3::TcpL4Protocol::SocketType", TypeIdValue(TcpCubic::GetTypeId()));
-    } else if (algorithm == "Vegas") {
-        Config::SetDefault("ns3::TcpL4Protocol::SocketType", TypeIdValue(TcpVegas::GetTypeId()));
-    } else {
-        // 默认使用NewReno
-        Config::SetDefault("ns3::TcpL4Protocol::SocketType", TypeIdValue(TcpNewReno::GetTypeId()));
+void SetupDumbbell(uint32_t flows, const std::string& dataRate, const std::string& delay,
+                   const ErrorModelFactory& errorModels, Topology& topology) {
+    NodeContainer routers;
+    routers.Add(CreateObject<Node>(LeftRank(0)));
+    routers.Add(CreateObject<Node>(RightRank(0)));
+    NodeContainer leftLeaves;
+    NodeContainer rightLeaves;
+    for (uint32_t i = 0; i < flows; i++) {
+        leftLeaves.Add(CreateObject<Node>(LeftRank(i)));
+        rightLeaves.Add(CreateObject<Node>(RightRank(i)));
     }
-    NS_LOG_INFO("TCP Congestion Control Algorithm set to: " << algorithm);
-}
-
-/**
- * @brief 运行单个测试场景
- */
-void RunTestScenario(const std::string& scenarioName, 
-                    const std::string& dataRate, 
-                    const std::string& delay,
-                    double errorRate,
-                    const std::string& tcpAlgorithm,
-                    uint32_t packetSize,
-                    double simulationTime) {
-    
-    std::cout << "\n=== 测试场景: " << scenarioName << " ===" << std::endl;
-    std::cout << "数据率: " << dataRate << ", 延迟: " << delay;
-    if (errorRate > 0) std::cout << ", 错误率: " << errorRate;
-    std::cout << ", TCP算法: " << tcpAlgorithm << std::endl;
-    
-    // 重置统计
-    protocolStats.clear();
-    protocolStats["TCP"] = ProtocolStats();
-    protocolStats["UDP"] = ProtocolStats();
-    
-    // 设置TCP拥塞控制算法
-    SetTcpCongestionControl(tcpAlgorithm);
     
-    // 创建节点
-    NodeContainer nodes;
-    nodes.Create(2);
+    // 安装协议栈（只分配IPv4地址，不安装IPv6）
+    InternetStackHelper stack;
+    stack.SetIpv6StackInstall(false);
+    stack.Install(routers);
+    stack.Install(leftLeaves);
+    stack.Install(rightLeaves);
     
-    NetDeviceContainer devices;
-    Ipv4InterfaceContainer interfaces;
+    // 瓶颈链路
+    PointToPointHelper bottleneck;
+    bottleneck.SetDeviceAttribute("DataRate", StringValue(dataRate));
+    bottleneck.SetChannelAttribute("Delay", StringValue(delay));
+    NetDeviceContainer bottleneckDevices = bottleneck.Install(routers.Get(0), routers.Get(1));
+    if (errorModels.IsEnabled()) {
+        errorModels.Install(bottleneckDevices, true, ERROR_MODEL_STREAM);
+    }
     
-    // 配置网络
-    SetupNetwork(nodes, devices, interfaces, dataRate, delay, errorRate);
-    
-    // 服务器端口
-    uint16_t tcpPort = 5000;
-    uint16_t udpPort = 5001;
-    
-    // 安装TCP服务器
-    Ptr<TcpStatsServer> tcpServer = CreateObject<TcpStatsServer>();
-    tcpServer->Setup(tcpPort);
-    nodes.Get(1)->AddApplication(tcpServer);
-    tcpServer->SetStartTime(Seconds(1.0));
-    tcpServer->SetStopTime(Seconds(simulationTime));
-    
-    // 安装UDP服务器
-    Ptr<UdpStatsServer> udpServer = CreateObject<UdpStatsServer>();
-    udpServer->Setup(udpPort);
-    nodes.Get(1)->AddApplication(udpServer);
-    udpServer->SetStartTime(Seconds(1.0));
-    udpServer->SetStopTime(Seconds(simulationTime));
-    
-    // 安装TCP客户端 (BulkSend)
-    BulkSendHelper tcpClient("ns3::TcpSocketFactory", 
-                            InetSocketAddress(interfaces.GetAddress(1), tcpPort));
-    tcpClient.SetAttribute("MaxBytes", UintegerValue(0)); // 无限发送
-    tcpClient.SetAttribute("SendSize", UintegerValue(packetSize));
-    ApplicationContainer tcpClientApp = tcpClient.Install(nodes.Get(0));
-    tcpClientApp.Start(Seconds(2.0));
-    tcpClientApp.Stop(Seconds(simulationTime - 1));
-    
-    // 安装UDP客户端 (OnOff)
-    OnOffHelper udpClient("ns3::UdpSocketFactory", 
-                         InetSocketAddress(interfaces.GetAddress(1), udpPort));
-    udpClient.SetAttribute("OnTime", StringValue("ns3::ConstantRandomVariable[Constant=1]"));
-    udpClient.SetAttribute("OffTime", StringValue("ns3::ConstantRandomVariable[Constant=0]"));
-    udpClient.SetAttribute("DataRate", DataRateValue(DataRate(dataRate)));
-    udpClient.SetAttribute("PacketSize", UintegerValue(packetSize));
-    ApplicationContainer udpClientApp = udpClient.Install(nodes.Get(0));
-    udpClientApp.Start(Seconds(2.0));
-    udpClientApp.Stop(Seconds(simulationTime - 1));
+    Ipv4AddressHelper bottleneckAddress("10.0.0.0", "255.255.255.252");
+    Ipv4InterfaceContainer bottleneckInterfaces = bottleneckAddress.Assign(bottleneckDevices);
     
-    // 安装FlowMonitor用于更精确的统计
-    FlowMonitorHelper flowMonitor;
-    Ptr<FlowMonitor> monitor = flowMonitor.InstallAll();
+    // 接入链路
+    PointToPointHelper access;
+    access.SetDeviceAttribute("DataRate", StringValue(ACCESS_DATA_RATE));
+    access.SetChannelAttribute("Delay", StringValue(ACCESS_DELAY));
     
-    // 运行仿真
-    Simulator::Stop(Seconds(simulationTime));
-    Simulator::Run();
+    Ipv4AddressHelper leftAddress("10.1.0.0", "255.255.255.252");
+    Ipv4AddressHelper rightAddress("10.128.0.0", "255.255.255.252");
+    Ipv4StaticRoutingHelper routing;
     
-    // 收集FlowMonitor统计
-    monitor->CheckForLostPackets();
-    Ptr<Ipv4FlowClassifier> classifier = DynamicCast<Ipv4FlowClassifier>(flowMonitor.GetClassifier());
-    std::map<FlowId, FlowMonitor::FlowStats> stats = monitor->GetFlowStats();
+    topology.clients.reserve(flows);
+    topology.servers.reserve(flows);
+    topology.serverAddresses.reserve(flows);
+    topology.sharedNodes = false;
+    topology.bottleneckDevices = bottleneckDevices;
+    topology.perDeviceErrorModel = true;
     
-    // 更新统计信息
-    for (auto& flow : stats) {
-        FlowMonitor::FlowStats flowStats = flow.second;
-        Ipv4FlowClassifier::FiveTuple t = classifier->FindFlow(flow.first);
+    for (uint32_t i = 0; i < flows; i++) {
+        NetDeviceContainer leftDevices = access.Install(leftLeaves.Get(i), routers.Get(0));
+        Ipv4InterfaceContainer leftInterfaces = leftAddress.Assign(leftDevices);
+        leftAddress.NewNetwork();
+        routing.GetStaticRouting(leftInterfaces.Get(0).first)
+            ->SetDefaultRoute(leftInterfaces.GetAddress(1), leftInterfaces.Get(0).second);
         
-        if (t.destinationPort == tcpPort) {
-            protocolStats["TCP"].totalPacketsSent = flowStats.txPackets;
-            protocolStats["TCP"].totalPacketsReceived = flowStats.rxPackets;
-            protocolStats["TCP"].totalBytesReceived = flowStats.rxBytes;
-            if (flowStats.rxPackets > 0) {
-                protocolStats["TCP"].totalDelay = flowStats.delaySum.GetSeconds();
-            }
-        } else if (t.destinationPort == udpPort) {
-            protocolStats["UDP"].totalPacketsSent = flowStats.txPackets;
-            protocolStats["UDP"].totalPacketsReceived = flowStats.rxPackets;
-            protocolStats["UDP"].totalBytesReceived = flowStats.rxBytes;
-            if (flowStats.rxPackets > 0) {
-                protocolStats["UDP"].totalDelay = flowStats.delaySum.GetSeconds();
-            }
-        }
+        NetDeviceContainer rightDevices = access.Install(rightLeaves.Get(i), routers.Get(1));
+        Ipv4InterfaceContainer rightInterfaces = rightAddress.Assign(rightDevices);
+        rightAddress.NewNetwork();
+        routing.GetStaticRouting(rightInterfaces.Get(0).first)
+            ->SetDefaultRoute(rightInterfaces.GetAddress(1), rightInterfaces.Get(0).second);
+        
+        topology.clients.push_back(leftLeaves.Get(i));
+        topology.servers.push_back(rightLeaves.Get(i));
+        topology.serverAddresses.push_back(rightInterfaces.GetAddress(0));
     }
     
-    // 计算并输出性能指标
-    std::cout << "\n性能统计结果:" << std::endl;
-    std::cout << "协议\t吞吐量(Mbps)\t平均延迟(ms)\t丢包率(%)\t公平性指数" << std::endl;
+    // 路由器：对侧叶子网段经瓶颈链路转发
+    routing.GetStaticRouting(bottleneckInterfaces.Get(0).first)
+        ->AddNetworkRouteTo(Ipv4Address("10.128.0.0"), Ipv4Mask("255.128.0.0"),
+                            bottleneckInterfaces.GetAddress(1), bottleneckInterfaces.Get(0).second);
+    routing.GetStaticRouting(bottleneckInterfaces.Get(1).first)
+        ->AddNetworkRouteTo(Ipv4Address("10.0.0.0"), Ipv4Mask("255.128.0.0"),
+                            bottleneckInterfaces.GetAddress(0), bottleneckInterfaces.Get(1).second);
+}
+
+/**
+ * @brief 按拓扑名称创建网络（p2p 或 dumbbell）
+ */
+void SetupTopology(const std::string& name, uint32_t flows, const std::string& dataRate,
+                   const std::string& delay, const ErrorModelFactory& errorModels,
+                   bool perDeviceErrorModel, Topology& topology) {
+    if (name == "dumbbell") {
+        SetupDumbbell(flows, dataRate, delay, errorModels, topology);
+        return;
+    }
+    if (name != "p2p") {
+        NS_FATAL_ERROR("Unknown topology: " << name << " (expected p2p or dumbbell)");
+    }
     
-    double totalThroughput = 0.0;
-    std::vector<double> throughputs;
+    NodeContainer nodes;
+    nodes.Create(2);
+    NetDeviceContainer devices;
+    Ipv4InterfaceContainer interfaces;
+    SetupNetwork(nodes, devices, interfaces, dataRate, delay, errorModels, perDeviceErrorModel);
     
-    for (auto& proto : protocolStats) {
-        const std::string& protocol = proto.first;
-        ProtocolStats& stats = proto.second;
-        
-        double effectiveTime = simulationTime - 3.0; // 减去启动和停止时间
-        double throughput = (stats.totalBytesReceived * 8.0) / (effectiveTime * 1000000.0);
-        double avgDelay = (stats.totalPacketsReceived > 0) ? 
-                         (stats.totalDelay / stats.totalPacketsReceived) * 1000 : 0.0;
-        double packetLoss = (stats.totalPacketsSent > 0) ? 
-                          (1.0 - (double)stats.totalPacketsReceived / stats.totalPacketsSent) * 100 : 0.0;
-        
-        std::cout << protocol << "\t" 
-                  << std::fixed << std::setprecision(4) << throughput << "\t\t"
-                  << std::fixed << std::setprecision(2) << avgDelay << "\t\t"
-                  << std::fixed << std::setprecision(2) << packetLoss << "\t\t";
-        
-        totalThroughput += throughput;
-        throughputs.push_back(throughput);
+    topology.clients.assign(flows, nodes.Get(0));
+    topology.servers.assign(flows, nodes.Get(1));
+    topology.serverAddresses.assign(flows, interfaces.GetAddress(1));
+    topology.sharedNodes = true;
+    topology.bottleneckDevices = devices;
+    topology.perDeviceErrorModel = perDeviceErrorModel;
+}
+
+/**
+ * @brief TCP拥塞控制算法对应的套接字类型
+ */
+TypeId GetTcpSocketType(const std::string& algorithm) {
+    if (algorithm == "Cubic") {
+        return TcpCubic::GetTypeId();
+    } else if (algorithm == "Vegas") {
+        return TcpVegas::GetTypeId();
     }
-    
-    // 计算公平性指数 (Jain's Fairness Index)
-    double fairnessIndex = 0.0;
-    if (throughputs.size() > 0) {
-        double sum = 0.0, sumSquares = 0.0;
-        for (double t : throughputs) {
-            sum += t;
-            sumSquares += t * t;
+    // 默认使用NewReno
+    return TcpNewReno::GetTypeId();
+}
+
+/**
+ * @brief 设置TCP拥塞控制算法（全局默认值，对之后安装的协议栈生效）
+ */
+void SetTcpCongestionControl(const std::string& algorithm) {
+    Config::SetDefault("ns3::TcpL4Protocol::SocketType", TypeIdValue(GetTcpSocketType(algorithm)));
+    NS_LOG_INFO("TCP Congestion Control Algorithm set to: " << algorithm);
+}
+
+/**
+ * @brief 设置已安装协议栈的各节点的TCP拥塞控制算法（复用拓扑时使用，不改全局默认值）
+ */
+void SetNodesTcpCongestionControl(const std::string& algorithm) {
+    TypeIdValue socketType(GetTcpSocketType(algorithm));
+    for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); ++node) {
+        Ptr<TcpL4Protocol> tcp = (*node)->GetObject<TcpL4Protocol>();
+        if (tcp) {
+            tcp->SetAttribute("SocketType", socketType);
         }
-        fairnessIndex = (sum * sum) / (throughputs.size() * sumSquares);
     }
-    
-    std::cout << "\n公平性指数: " << std::fixed << std::setprecision(4) << fairnessIndex << std::endl;
-    
-    Simulator::Destroy();
+    NS_LOG_INFO("TCP Congestion Control Algorithm set to: " << algorithm);
 }
 
 /**
- * @brief 主函数
+ * @brief 单个测试场景的配置
  */
-int main(int argc, char *argv[]) {
-    // 默认参数
-    std::string dataRate = "10Mbps";
-    std::string delay = "2ms";
-    double errorRate = 0.0;
-    std::string tcpAlgorithm = "NewReno";
-    uint32_t packetSize = 1024;
-    double simulationTime = 20.0;
-    
-    // 命令行参数解析
-    CommandLine cmd;
-    cmd.AddValue("dataRate", "PointToPoint link data rate", dataRate);
-    cmd.AddValue("delay", "PointToPoint link delay", delay);
-    cmd.AddValue("errorRate", "Packet error rate", errorRate);
-    cmd.AddValue("tcpAlgorithm", "TCP congestion control algorithm (NewReno, Cubic, Vegas)", tcpAlgorithm);
-    cmd.AddValue("packetSize", "Packet size in bytes", packetSize);
-    cmd.AddValue("simulationTime", "Simulation time in seconds", simulationTime);
-    cmd.Parse(argc, argv);
-    
-    std::cout << "=== TCP vs UDP 协议性能对比研究 ===" << std::endl;
-    std::cout << "默认参数: 数据率=" << dataRate << ", 延迟=" << delay;
-    if (errorRate > 0) std::cout << ", 错误率=" << errorRate;
-    std::cout << ", TCP算法=" << tcpAlgorithm << ", 包大小=" << packetSize << "B" << std::endl;
-    
-    // 测试场景1: 理想网络条件
-    RunTestScenario("理想网络条件", "10Mbps", "2ms", 0.0, "NewReno", packetSize, simulationTime);
-    
-    // 测试场景2: 高延迟网络
-    RunTestScenario("高延迟网络", "10Mbps", "50ms", 0.0, "NewReno", packetSize, simulationTime);
-    
-    // 测试场景3: 有丢包网络
-    RunTestScenario("有丢包网络", "10Mbps", "2ms", 0.01, "NewReno", packetSize, simulationTime);
-    
-    // 测试场景4: 低带宽网络
-    RunTestScenario("低带宽网络", "1Mbps", "2ms", 0.0, "NewReno", packetSize, simulationTime);
-    
-    // 测试场景5: 不同TCP拥塞控制算法
-    RunTestScenario("TCP Cubic算法", "10Mbps", "2ms", 0.0, "Cubic", packetSize, simulationTime);
-    RunTestScenario("TCP Vegas算法", "10Mbps", "2ms", 0.0, "Vegas", packetSize, simulationTime);
-    
-    // 测试场景6: 混合网络条件
-    RunTestScenario("混合网络条件", "5Mbps", "20ms", 0.005, "NewReno", packetSize, simulationTime);
-    
-    std::cout << "\n=== 所有测试场景完成 ===" << std::endl;
-    std::cout << "测试总结:" << std::endl;
-    std::cout << "1. TCP在拥塞网络中表现更好，能够自适应调整发送速率" << std::endl;
-    std::cout << "2. UDP在低延迟要求下表现更好，但缺乏拥塞控制" << std::endl;
-    std::cout << "3. 不同TCP算法在不同网络条件下表现各异" << std::endl;
-    std::cout << "4. 公平性指数反映了协议间的资源分配公平性" << std::endl;
+struct ScenarioConfig {
+    std::string name;
+    std::string dataRate;
+    std::string delay;
+    double errorRate;
+    std::string tcpAlgorithm;
+    uint32_t packetSize;
+    double simulationTime;
+    uint64_t run;           // RNG运行编号
+    std::string topology = "p2p";   // p2p 或 dumbbell
+    uint32_t flows = 1;             // 客户端/服务器对数，每对一条TCP流和一条UDP流
+    bool flowMonitor = true;        // false 时只用应用层计数器统计
+    std::string errorModel = "rate";    // rate、burst 或 gilbert
+    std::string burstParams;            // 错误模型参数，见 error-model-factory.h
+    bool perDeviceErrorModel = true;    // p2p链路两端各用一个错误模型
+    std::string flowSamples;            // 非空时按时间间隔把各流增量写入此文件
+    std::string flowSampleFormat = "bin";
+    double flowSampleInterval = 0.1;
+    std::string fidelity = "packet";    // packet：包级仿真；fluid：流体模型；hybrid：包级预热后外推
+    double hybridTime = 10.0;           // hybrid 模式下包级仿真的时长（秒）
+    std::string udpDataRate;            // UDP的总发送速率（各流平分），为空时等于链路速率
+    double checkpoint = 0.0;            // 大于0时从该时刻的检查点分叉运行，只统计检查点之后
+};
+
+/**
+ * @brief 单个流的统计结果（统计槽表在报告时的快照）
+ */
+struct FlowResult {
+    std::string protocol;
+    uint32_t flow;
+    uint16_t port;
+    ProtocolStats stats;
+};
+
+/**
+ * @brief 单个场景的结果：各流统计、各协议的时延直方图和仿真开销
+ */
+struct ScenarioResult {
+    std::vector<FlowResult> flows;
+    std::map<std::string, LatencyHistogram> latency;
+    SimulationProfile profile;  // 分布式运行时为本进程（rank 0）的开销
+};
+
+/**
+ * @brief 由统计槽表生成场景结果，流按登记顺序排列
+ */
+ScenarioResult SnapshotStatsTable(const StatsTable& table) {
+    ScenarioResult result;
+    result.flows.reserve(table.GetSize());
+    for (uint32_t slot = 0; slot < table.GetSize(); slot++) {
+        result.flows.push_back(FlowResult{table.GetProtocol(slot), table.GetFlow(slot),
+                                          table.GetPort(slot), table.GetStats(slot)});
+    }
+    result.latency = table.GetLatencyHistograms();
+    return result;
+}
+
+/**
+ * @brief 汇总场景结果中某一协议的所有流
+ */
+ProtocolStats SumProtocolStats(const ScenarioResult& result, const std::string& protocol) {
+    ProtocolStats sum;
+    bool first = true;
+    for (const FlowResult& flow : result.flows) {
+        if (flow.protocol != protocol) {
+            continue;
+        }
+        sum.totalBytesReceived += flow.stats.totalBytesReceived;
+        sum.totalPacketsReceived += flow.stats.totalPacketsReceived;
+        sum.totalDelay += flow.stats.totalDelay;
+        sum.delaySamples += flow.stats.delaySamples;
+        sum.totalPacketsSent += flow.stats.totalPacketsSent;
+        sum.startTime = first ? flow.stats.startTime : std::min(sum.startTime, flow.stats.startTime);
+        sum.stopTime = std::max(sum.stopTime, flow.stats.stopTime);
+        first = false;
+    }
+    return sum;
+}
+
+/**
+ * @brief 向字节串追加一个长度前缀的字符串
+ */
+void AppendString(std::string& out, const std::string& value) {
+    uint32_t size = value.size();
+    out.append(reinterpret_cast<const char*>(&size), sizeof(size));
+    out.append(value);
+}
+
+/**
+ * @brief 从字节串读出 size 字节到 dest
+ */
+void ExtractBytes(const std::string& data, size_t& offset, void* dest, size_t size) {
+    if (data.size() - offset < size) {
+        NS_FATAL_ERROR("Corrupted scenario result");
+    }
+    std::memcpy(dest, data.data() + offset, size);
+    offset += size;
+}
+
+/**
+ * @brief 从字节串读出一个长度前缀的字符串
+ */
+std::string ExtractString(const std::string& data, size_t& offset) {
+    uint32_t size = 0;
+    ExtractBytes(data, offset, &size, sizeof(size));
+    if (data.size() - offset < size) {
+        NS_FATAL_ERROR("Corrupted scenario result");
+    }
+    std::string value = data.substr(offset, size);
+    offset += size;
+    return value;
+}
+
+/**
+ * @brief 将场景结果序列化为字节串（用于工作进程通过管道回传）
+ */
+std::string SerializeScenarioResult(const ScenarioResult& result) {
+    std::string out;
+    uint32_t flowCount = result.flows.size();
+    out.append(reinterpret_cast<const char*>(&flowCount), sizeof(flowCount));
+    for (const FlowResult& flow : result.flows) {
+        AppendString(out, flow.protocol);
+        out.append(reinterpret_cast<const char*>(&flow.flow), sizeof(flow.flow));
+        out.append(reinterpret_cast<const char*>(&flow.port), sizeof(flow.port));
+        out.append(reinterpret_cast<const char*>(&flow.stats), sizeof(ProtocolStats));
+    }
+    uint32_t histogramCount = result.latency.size();
+    out.append(reinterpret_cast<const char*>(&histogramCount), sizeof(histogramCount));
+    for (const auto& histogram : result.latency) {
+        AppendString(out, histogram.first);
+        AppendString(out, histogram.second.Serialize());
+    }
+    out.append(reinterpret_cast<const char*>(&result.profile), sizeof(SimulationProfile));
+    return out;
+}
+
+/**
+ * @brief 从字节串恢复场景结果
+ */
+ScenarioResult DeserializeScenarioResult(const std::string& data) {
+    ScenarioResult result;
+    size_t offset = 0;
+    uint32_t flowCount = 0;
+    ExtractBytes(data, offset, &flowCount, sizeof(flowCount));
+    result.flows.resize(flowCount);
+    for (FlowResult& flow : result.flows) {
+        flow.protocol = ExtractString(data, offset);
+        ExtractBytes(data, offset, &flow.flow, sizeof(flow.flow));
+        ExtractBytes(data, offset, &flow.port, sizeof(flow.port));
+        ExtractBytes(data, offset, &flow.stats, sizeof(ProtocolStats));
+    }
+    uint32_t histogramCount = 0;
+    ExtractBytes(data, offset, &histogramCount, sizeof(histogramCount));
+    for (uint32_t i = 0; i < histogramCount; i++) {
+        std::string protocol = ExtractString(data, offset);
+        result.latency[protocol].Deserialize(ExtractString(data, offset));
+    }
+    ExtractBytes(data, offset, &result.profile, sizeof(SimulationProfile));
+    if (offset != data.size()) {
+        NS_FATAL_ERROR("Corrupted scenario result");
+    }
+    return result;
+}
+
+/**
+ * @brief 客户端每发送一个数据包计数一次（不使用FlowMonitor时的发送统计）
+ */
+void CountSentPacket(ProtocolStats* stats, Ptr<const Packet> packet) {
+    stats->totalPacketsSent++;
+}
+
+/**
+ * @brief 为每个槽位登记一个流分组（按目的地址、端口和协议），安装应用后调用一次
+ */
+void RegisterFlowGroups(FlowAggregator& aggregator, const StatsTable& statsTable) {
+    for (uint32_t slot = 0; slot < statsTable.GetSize(); slot++) {
+        uint32_t group = aggregator.AddGroup(statsTable.GetProtocol(slot));
+        uint8_t protocol = statsTable.GetProtocol(slot) == "TCP" ? FlowAggregator::TCP : FlowAggregator::UDP;
+        aggregator.Map(statsTable.GetAddress(slot), statsTable.GetPort(slot), protocol, group);
+    }
+}
+
+/**
+ * @brief 用FlowMonitor的统计覆盖各槽位的应用层计数
+ *
+ * 分组编号与槽位编号一致；同一槽位的多条流（如多个源端口）累加而不是互相覆盖。
+ */
+void ApplyFlowMonitorStats(Ptr<FlowMonitor> monitor, FlowAggregator& aggregator, StatsTable& statsTable) {
+    monitor->CheckForLostPackets();
+    aggregator.Aggregate(monitor->GetFlowStats());
+    
+    // 更新统计信息
+    for (uint32_t slot = 0; slot < statsTable.GetSize(); slot++) {
+        const FlowAggregator::GroupStats& flowStats = aggregator.Get(slot);
+        if (flowStats.flows == 0) {
+            continue;
+        }
+        ProtocolStats* slotStats = statsTable.GetSlot(slot);
+        slotStats->totalPacketsSent = flowStats.txPackets;
+        slotStats->totalPacketsReceived = flowStats.rxPackets;
+        slotStats->totalBytesReceived = flowStats.rxBytes;
+        if (flowStats.rxPackets > 0) {
+            slotStats->totalDelay = flowStats.delaySum.GetSeconds();
+            slotStats->delaySamples = flowStats.rxPackets;
+        }
+    }
+}
+
+/**
+ * @brief 分布式运行时把各进程的统计归约到0号进程
+ *
+ * 所有进程按相同顺序登记槽位，因此槽位编号（流编号+协议）在各进程间一致。
+ * 每个计数只由一个进程写入（发送计数在发送端所在进程，接收计数在接收端所在进程），
+ * 其余进程为零，按槽位逐字段求和即得到完整结果；时延直方图按桶求和。
+ */
+void ReduceScenarioResult(ScenarioResult& result) {
+#ifdef NS3_MPI
+    if (partition.systemCount <= 1) {
+        return;
+    }
+    std::vector<uint64_t> counters;
+    std::vector<double> values;
+    counters.reserve(4 * result.flows.size());
+    values.reserve(3 * result.flows.size());
+    for (const FlowResult& flow : result.flows) {
+        counters.push_back(flow.stats.totalBytesReceived);
+        counters.push_back(flow.stats.totalPacketsReceived);
+        counters.push_back(flow.stats.totalPacketsSent);
+        counters.push_back(flow.stats.delaySamples);
+        values.push_back(flow.stats.totalDelay);
+        values.push_back(flow.stats.startTime);
+        values.push_back(flow.stats.stopTime);
+    }
+    std::vector<uint64_t> counterSums(counters.size());
+    std::vector<double> valueSums(values.size());
+    MPI_Reduce(counters.data(), counterSums.data(), counters.size(), MPI_UINT64_T, MPI_SUM, 0,
+               MpiInterface::GetCommunicator());
+    MPI_Reduce(values.data(), valueSums.data(), values.size(), MPI_DOUBLE, MPI_SUM, 0,
+               MpiInterface::GetCommunicator());
+    for (size_t i = 0; i < result.flows.size(); i++) {
+        ProtocolStats& stats = result.flows[i].stats;
+        stats.totalBytesReceived = counterSums[4 * i];
+        stats.totalPacketsReceived = counterSums[4 * i + 1];
+        stats.totalPacketsSent = counterSums[4 * i + 2];
+        stats.delaySamples = counterSums[4 * i + 3];
+        stats.totalDelay = valueSums[3 * i];
+        stats.startTime = valueSums[3 * i + 1];
+        stats.stopTime = valueSums[3 * i + 2];
+    }
+    
+    // 时延直方图：所有进程的协议集合相同（登记时创建），按桶求和
+    for (auto& histogram : result.latency) {
+        std::vector<uint64_t> buckets = histogram.second.GetBuckets();
+        std::vector<uint64_t> bucketSums(buckets.size());
+        double sum = histogram.second.GetSum();
+        double sumTotal = 0.0;
+        MPI_Reduce(buckets.data(), bucketSums.data(), buckets.size(), MPI_UINT64_T, MPI_SUM, 0,
+                   MpiInterface::GetCommunicator());
+        MPI_Reduce(&sum, &sumTotal, 1, MPI_DOUBLE, MPI_SUM, 0, MpiInterface::GetCommunicator());
+        histogram.second.SetBuckets(bucketSums, sumTotal);
+    }
+#endif
+}
+
+/**
+ * @brief UDP客户端的总发送速率（未指定 udpDataRate 时等于链路速率）
+ */
+DataRate GetUdpDataRate(const ScenarioConfig& config) {
+    return DataRate(config.udpDataRate.empty() ? config.dataRate : config.udpDataRate);
+}
+
+/**
+ * @brief 读取属性的当前默认值（包含命令行 --ns3::类型::属性 的修改），返回其字符串形式
+ */
+std::string GetAttributeDefault(const std::string& typeName, const std::string& attribute) {
+    TypeId::AttributeInformation info;
+    if (!TypeId::LookupByName(typeName).LookupAttributeByName(attribute, &info)) {
+        NS_FATAL_ERROR("Unknown attribute " << typeName << "::" << attribute);
+    }
+    return info.initialValue->SerializeToString(info.checker);
+}
+
+// 流体模式折算计数时使用的每包头部字节数
+const uint32_t PPP_HEADER_BYTES = 2;
+const uint32_t IPV4_HEADER_BYTES = 20;
+const uint32_t UDP_HEADER_BYTES = 8;
+
+/**
+ * @brief 由流体模型的稳态把一个流折算为与包级模式相同的计数
+ *
+ * wireBytes 为每包在链路上的字节数，countedBytes 为每个接收包计入 totalBytesReceived 的字节数，
+ * delay 为每个接收包记录的单向时延（秒）。
+ */
+FlowResult MakeFluidFlowResult(const std::string& protocol, uint32_t flow, uint16_t port,
+                               const FluidLinkModel::FlowState& state, uint32_t wireBytes,
+                               uint32_t countedBytes, double delay, double activeTime,
+                               LatencyHistogram& histogram) {
+    double packetBits = wireBytes * 8.0;
+    ProtocolStats stats;
+    stats.totalPacketsSent = std::llround(state.sendRate * activeTime / packetBits);
+    stats.totalPacketsReceived = std::llround(state.deliveredRate * activeTime / packetBits);
+    stats.totalBytesReceived = stats.totalPacketsReceived * countedBytes;
+    stats.totalDelay = stats.totalPacketsReceived * delay;
+    stats.delaySamples = stats.totalPacketsReceived;
+    stats.startTime = 2.0;
+    stats.stopTime = 2.0 + activeTime;
+    histogram.Record(static_cast<uint64_t>(delay * 1e9), stats.totalPacketsReceived);
+    return FlowResult{protocol, flow, port, stats};
+}
+
+/**
+ * @brief 流体模型用到的 ns-3 属性默认值
+ */
+struct FluidDefaults {
+    FluidLinkModel::Tcp tcp;    // 不含拥塞控制算法
+    double sendBuffer;          // 字节，TCP 发送缓冲区
+    double aqmTarget;           // s
+};
+
+/**
+ * @brief 读取流体模型用到的属性默认值，首次调用时读取一次
+ *
+ * 读取属性会复制引用计数非原子的 Ptr，多个线程同时读取不安全；局部静态变量的初始化
+ * 只执行一次且线程安全，之后线程池中并发运行的流体任务都只读这份副本。
+ * 命令行在任何场景运行之前解析，因此 --ns3::类型::属性 的修改都已生效。
+ */
+const FluidDefaults& GetFluidDefaults() {
+    static const FluidDefaults defaults = []() {
+        FluidDefaults d;
+        d.tcp.segmentSize = std::stoul(GetAttributeDefault("ns3::TcpSocket", "SegmentSize"));
+        bool timestamps = GetAttributeDefault("ns3::TcpSocketBase", "Timestamp") == "true";
+        uint32_t tcpHeaderBytes = timestamps ? 32 : 20;
+        d.tcp.headerBytes = tcpHeaderBytes + IPV4_HEADER_BYTES + PPP_HEADER_BYTES;
+        d.sendBuffer = std::stod(GetAttributeDefault("ns3::TcpSocket", "SndBufSize"));
+        d.tcp.maxWindow = std::min(std::stod(GetAttributeDefault("ns3::TcpSocket", "RcvBufSize")),
+                                   d.sendBuffer);
+        d.tcp.minRto = Time(GetAttributeDefault("ns3::TcpSocketBase", "MinRto")).GetSeconds();
+        d.tcp.delAckCount = std::stoul(GetAttributeDefault("ns3::TcpSocket", "DelAckCount"));
+        d.tcp.cubicC = std::stod(GetAttributeDefault("ns3::TcpCubic", "C"));
+        d.tcp.cubicBeta = std::stod(GetAttributeDefault("ns3::TcpCubic", "Beta"));
+        d.tcp.vegasAlpha = std::stod(GetAttributeDefault("ns3::TcpVegas", "Alpha"));
+        d.tcp.vegasBeta = std::stod(GetAttributeDefault("ns3::TcpVegas", "Beta"));
+        d.aqmTarget = Time(GetAttributeDefault("ns3::FqCoDelQueueDisc", "Target")).GetSeconds();
+        return d;
+    }();
+    return defaults;
+}
+
+/**
+ * @brief 流体模式：不做包级仿真，由 FluidLinkModel 计算各流在瓶颈链路上的稳态结果
+ *
+ * 模型参数取自与包级仿真相同的配置和 ns-3 属性默认值（TCP 段大小、收发缓冲区、最小 RTO、
+ * 时间戳选项、FqCoDel 目标时延等）。各流按应用发送区间 [2, simulationTime-1] 的稳态速率
+ * 折算为计数，不计慢启动；FlowMonitor 统计 IP 层字节，应用计数器统计载荷字节，与包级一致。
+ * 每个流的时延直方图只有均值一个点。TCP 时延与包级一样从写入发送缓冲区算起：发送端始终写满
+ * 缓冲区，由 Little 定律每个字节在缓冲区中停留 SndBufSize / 吞吐量直到被确认，读出比确认早
+ * 一个ACK的单向时延。哑铃拓扑的接入链路不作为瓶颈。
+ * 不使用仿真器和全局状态，可以在多个线程中并发运行。
+ */
+ScenarioResult RunFluidScenario(const ScenarioConfig& config) {
+    auto wallStart = std::chrono::steady_clock::now();
+    uint32_t flows = config.flows;
+    if (flows == 0) {
+        NS_FATAL_ERROR("flows must be at least 1");
+    }
+    if (config.topology != "p2p" && config.topology != "dumbbell") {
+        NS_FATAL_ERROR("Unknown topology: " << config.topology << " (expected p2p or dumbbell)");
+    }
+    ErrorModelFactory errorModels(config.errorModel, config.errorRate, config.burstParams);
+    
+    const FluidDefaults& defaults = GetFluidDefaults();
+    FluidLinkModel::Tcp tcp = defaults.tcp;
+    tcp.variant = FluidLinkModel::ParseTcpVariant(config.tcpAlgorithm);
+    
+    // 单向时延：传播时延加发送时延；哑铃拓扑两侧各多一条接入链路
+    double capacity = DataRate(config.dataRate).GetBitRate();
+    double delay = Time(config.delay).GetSeconds();
+    double accessRate = DataRate(ACCESS_DATA_RATE).GetBitRate();
+    double accessDelay = Time(ACCESS_DELAY).GetSeconds();
+    bool dumbbell = config.topology == "dumbbell";
+    auto oneWayDelay = [&](uint32_t bytes) {
+        double d = delay + bytes * 8.0 / capacity;
+        if (dumbbell) {
+            d += 2 * (accessDelay + bytes * 8.0 / accessRate);
+        }
+        return d;
+    };
+    uint32_t tcpWireBytes = tcp.segmentSize + tcp.headerBytes;
+    uint32_t udpWireBytes = config.packetSize + UDP_HEADER_BYTES + IPV4_HEADER_BYTES + PPP_HEADER_BYTES;
+    
+    FluidLinkModel::Link link;
+    link.capacity = capacity;
+    link.baseRtt = oneWayDelay(tcpWireBytes) + oneWayDelay(tcp.headerBytes);
+    link.lossRate = errorModels.GetLossRate();
+    link.aqmTarget = defaults.aqmTarget;
+    
+    // 与包级模式相同：每对节点一个TCP流和一个平分链路速率（按载荷计）的UDP流
+    FluidLinkModel model(link, tcp);
+    double udpRate = GetUdpDataRate(config).GetBitRate() / flows * udpWireBytes / config.packetSize;
+    std::vector<uint32_t> tcpFlows;
+    std::vector<uint32_t> udpFlows;
+    for (uint32_t i = 0; i < flows; i++) {
+        tcpFlows.push_back(model.AddTcpFlow());
+        udpFlows.push_back(model.AddCbrFlow(udpRate));
+    }
+    model.Solve();
+    
+    uint32_t tcpCountedBytes = config.flowMonitor ? tcpWireBytes - PPP_HEADER_BYTES : tcp.segmentSize;
+    uint32_t udpCountedBytes = config.flowMonitor ? udpWireBytes - PPP_HEADER_BYTES : config.packetSize;
+    double activeTime = config.simulationTime - 3.0;
+    ScenarioResult result;
+    result.flows.reserve(2 * flows);
+    for (uint32_t i = 0; i < flows; i++) {
+        uint16_t tcpPort = TCP_BASE_PORT + (dumbbell ? 0 : 2 * i);
+        uint16_t udpPort = UDP_BASE_PORT + (dumbbell ? 0 : 2 * i);
+        const FluidLinkModel::FlowState& tcpState = model.GetFlow(tcpFlows[i]);
+        const FluidLinkModel::FlowState& udpState = model.GetFlow(udpFlows[i]);
+        double tcpDelay = oneWayDelay(tcpWireBytes) + tcpState.queueDelay;
+        double tcpGoodput = tcpState.deliveredRate * tcp.segmentSize / tcpWireBytes;
+        if (tcpGoodput > 0) {
+            tcpDelay = std::max(tcpDelay, defaults.sendBuffer * 8.0 / tcpGoodput -
+                                              oneWayDelay(tcp.headerBytes));
+        }
+        result.flows.push_back(MakeFluidFlowResult("TCP", i, tcpPort, tcpState,
+                                                   tcpWireBytes, tcpCountedBytes,
+                                                   tcpDelay, activeTime, result.latency["TCP"]));
+        result.flows.push_back(MakeFluidFlowResult("UDP", i, udpPort, udpState,
+                                                   udpWireBytes, udpCountedBytes,
+                                                   oneWayDelay(udpWireBytes) + udpState.queueDelay,
+                                                   activeTime, result.latency["UDP"]));
+    }
+    
+    result.profile.wallSeconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    result.profile.simulatedSeconds = config.simulationTime;
+    return result;
+}
+
+/**
+ * @brief hybrid 模式：仿真中途登记一次快照（FlowMonitor 统计先写回槽表）
+ */
+void SnapshotScenario(Ptr<FlowMonitor> monitor, FlowAggregator* aggregator, StatsTable* statsTable,
+                      ScenarioResult* snapshot) {
+    if (monitor) {
+        ApplyFlowMonitorStats(monitor, *aggregator, *statsTable);
+    }
+    *snapshot = SnapshotStatsTable(*statsTable);
+}
+
+/**
+ * @brief hybrid 模式：按快照时刻 from 到包级仿真结束 to 之间的计数增量，把结果线性外推到 fullTo
+ */
+void ExtrapolateScenarioResult(ScenarioResult& result, const ScenarioResult& snapshot,
+                               double from, double to, double fullTo) {
+    if (snapshot.flows.size() != result.flows.size()) {
+        NS_FATAL_ERROR("Hybrid snapshot does not match the scenario result");
+    }
+    double factor = (fullTo - to) / (to - from);
+    auto extend = [factor](double total, double atSnapshot) {
+        return total + (total - atSnapshot) * factor;
+    };
+    for (size_t i = 0; i < result.flows.size(); i++) {
+        ProtocolStats& stats = result.flows[i].stats;
+        const ProtocolStats& early = snapshot.flows[i].stats;
+        stats.totalBytesReceived = std::llround(extend(stats.totalBytesReceived, early.totalBytesReceived));
+        stats.totalPacketsReceived = std::llround(extend(stats.totalPacketsReceived, early.totalPacketsReceived));
+        stats.totalPacketsSent = std::llround(extend(stats.totalPacketsSent, early.totalPacketsSent));
+        stats.delaySamples = std::llround(extend(stats.delaySamples, early.delaySamples));
+        stats.totalDelay = extend(stats.totalDelay, early.totalDelay);
+        if (stats.stopTime > 0) {
+            stats.stopTime += fullTo - to;
+        }
+    }
+    for (auto& histogram : result.latency) {
+        auto early = snapshot.latency.find(histogram.first);
+        if (early == snapshot.latency.end()) {
+            continue;
+        }
+        std::vector<uint64_t> buckets = histogram.second.GetBuckets();
+        const std::vector<uint64_t>& earlyBuckets = early->second.GetBuckets();
+        for (size_t j = 0; j < buckets.size(); j++) {
+            buckets[j] = std::llround(extend(buckets[j], earlyBuckets[j]));
+        }
+        histogram.second.SetBuckets(buckets, extend(histogram.second.GetSum(), early->second.GetSum()));
+    }
+}
+
+/**
+ * @brief 检查点分叉：预热一次，从检查点为每个变体分叉运行尾段
+ *
+ * 主进程按预热配置仿真到 checkpoint 后暂停，每个变体在从该时刻分叉出的子进程中
+ * 换上自己的错误率和UDP速率，清零统计后运行到结束，因此 N 个变体只需一次预热。
+ * 变体与预热配置只能在 errorRate 和 udpDataRate 上不同。
+ */
+struct CheckpointBranches {
+    std::vector<ScenarioConfig> variants;
+    ForkWorkerPool* pool;                   // 运行尾段的进程池（须为 SetIsolated(true)）
+    std::vector<ScenarioResult> results;    // 与 variants 一一对应
+};
+
+/**
+ * @brief 按配置重新创建瓶颈链路的错误模型（使用相同的随机数流编号，丢包序列可复现）
+ */
+void ReinstallErrorModels(const ScenarioConfig& config, const Topology& topology) {
+    ErrorModelFactory errorModels(config.errorModel, config.errorRate, config.burstParams);
+    if (errorModels.IsEnabled()) {
+        errorModels.Install(topology.bottleneckDevices, topology.perDeviceErrorModel, ERROR_MODEL_STREAM);
+    } else {
+        for (uint32_t i = 0; i < topology.bottleneckDevices.GetN(); i++) {
+            topology.bottleneckDevices.Get(i)->SetAttribute("ReceiveErrorModel", PointerValue());
+        }
+    }
+}
+
+/**
+ * @brief 在检查点处换上变体的错误模型和UDP发送速率
+ */
+void ApplyCheckpointVariant(const ScenarioConfig& variant, const Topology& topology,
+                            const std::vector<Ptr<Application>>& udpClients) {
+    ReinstallErrorModels(variant, topology);
+    DataRate udpRate(GetUdpDataRate(variant).GetBitRate() / variant.flows);
+    for (const Ptr<Application>& client : udpClients) {
+        client->SetAttribute("DataRate", DataRateValue(udpRate));
+    }
+}
+
+/**
+ * @brief 检查场景配置并建立网络拓扑（只有节点、链路、协议栈和路由，不含应用）
+ *
+ * RNG运行编号和TCP拥塞控制算法在建拓扑之前设置，因为协议栈创建时就会用到。
+ */
+void BuildScenarioTopology(const ScenarioConfig& config, Topology& topology) {
+    RngSeedManager::SetRun(config.run);
+    
+    uint32_t flows = config.flows;
+    if (flows == 0) {
+        NS_FATAL_ERROR("flows must be at least 1");
+    }
+    if (config.topology == "p2p" && UDP_BASE_PORT + 2 * (flows - 1) > 65535) {
+        NS_FATAL_ERROR("Too many flows for the p2p topology: " << flows);
+    }
+    if (partition.systemCount > 1) {
+        if (config.topology != "dumbbell") {
+            NS_FATAL_ERROR("Distributed runs require --topology=dumbbell");
+        }
+        if (config.flowMonitor) {
+            NS_FATAL_ERROR("FlowMonitor cannot track flows across MPI ranks; use --flowMonitor=false");
+        }
+    }
+    
+    // 设置TCP拥塞控制算法
+    SetTcpCongestionControl(config.tcpAlgorithm);
+    
+    // 配置网络
+    ErrorModelFactory errorModels(config.errorModel, config.errorRate, config.burstParams);
+    SetupTopology(config.topology, flows, config.dataRate, config.delay, errorModels,
+                  config.perDeviceErrorModel, topology);
+}
+
+/**
+ * @brief 复用拓扑：把已建好的拓扑改成 config 的链路速率、时延、错误模型和TCP算法
+ *
+ * 拓扑结构（拓扑类型、流数）必须与建拓扑时的配置相同。
+ */
+void ReconfigureTopology(const ScenarioConfig& config, const Topology& topology) {
+    for (uint32_t i = 0; i < topology.bottleneckDevices.GetN(); i++) {
+        topology.bottleneckDevices.Get(i)->SetAttribute("DataRate", StringValue(config.dataRate));
+    }
+    topology.bottleneckDevices.Get(0)->GetChannel()->SetAttribute("Delay", StringValue(config.delay));
+    ReinstallErrorModels(config, topology);
+    SetNodesTcpCongestionControl(config.tcpAlgorithm);
+}
+
+/**
+ * @brief 在建好的拓扑上安装应用并运行，返回各协议统计（不输出任何内容）
+ *
+ * branches 不为空时只把 config 作为预热配置运行到检查点，各变体的结果写入 branches->results，
+ * 返回值为空。
+ */
+ScenarioResult RunOnTopology(const ScenarioConfig& config, Topology& topology,
+                             CheckpointBranches* branches = nullptr) {
+    if (config.fidelity != "packet" && config.fidelity != "hybrid") {
+        NS_FATAL_ERROR("Unknown fidelity: " << config.fidelity << " (expected packet, fluid or hybrid)");
+    }
+    // hybrid：只做 hybridTime 秒的包级仿真，再外推到 simulationTime
+    bool hybrid = config.fidelity == "hybrid" && config.hybridTime < config.simulationTime;
+    double simulationTime = hybrid ? config.hybridTime : config.simulationTime;
+    uint32_t packetSize = config.packetSize;
+    uint32_t flows = config.flows;
+    
+    // 本次运行的统计槽表：每个流一个TCP服务器和一个UDP服务器
+    StatsTable statsTable;
+    statsTable.Reset(2 * flows);
+    
+    // UDP客户端 (OnOff)，各流平分UDP速率（默认为链路速率）
+    OnOffHelper udpClient("ns3::UdpSocketFactory", Address());
+    udpClient.SetAttribute("OnTime", StringValue("ns3::ConstantRandomVariable[Constant=1]"));
+    udpClient.SetAttribute("OffTime", StringValue("ns3::ConstantRandomVariable[Constant=0]"));
+    udpClient.SetAttribute("DataRate", DataRateValue(DataRate(GetUdpDataRate(config).GetBitRate() / flows)));
+    udpClient.SetAttribute("PacketSize", UintegerValue(packetSize));
+    // 每个数据报带发送时间戳，供服务器计算单向时延（包大小不变）
+    // （包太小放不下时间戳头时不启用，UDP时延统计为空）
+    udpClient.SetAttribute("EnableSeqTsSizeHeader",
+                           BooleanValue(packetSize >= SeqTsSizeHeader().GetSerializedSize()));
+    
+    // 所有进程都登记全部槽位（保证槽位编号一致），应用只安装在本进程的节点上
+    std::vector<Ptr<Application>> udpClients;
+    for (uint32_t i = 0; i < flows; i++) {
+        uint16_t tcpPort = TCP_BASE_PORT + (topology.sharedNodes ? 2 * i : 0);
+        uint16_t udpPort = UDP_BASE_PORT + (topology.sharedNodes ? 2 * i : 0);
+        Ipv4Address serverAddress = topology.serverAddresses[i];
+        uint32_t tcpSlot = statsTable.Register("TCP", i, serverAddress, tcpPort);
+        uint32_t udpSlot = statsTable.Register("UDP", i, serverAddress, udpPort);
+        
+        if (IsLocal(topology.servers[i])) {
+            // 安装TCP服务器
+            Ptr<TcpStatsServer> tcpServer = CreateObject<TcpStatsServer>();
+            tcpServer->Setup(tcpPort, &statsTable, tcpSlot);
+            topology.servers[i]->AddApplication(tcpServer);
+            tcpServer->SetStartTime(Seconds(1.0));
+            tcpServer->SetStopTime(Seconds(simulationTime));
+            
+            // 安装UDP服务器
+            Ptr<UdpStatsServer> udpServer = CreateObject<UdpStatsServer>();
+            udpServer->Setup(udpPort, &statsTable, udpSlot);
+            topology.servers[i]->AddApplication(udpServer);
+            udpServer->SetStartTime(Seconds(1.0));
+            udpServer->SetStopTime(Seconds(simulationTime));
+        }
+        
+        if (IsLocal(topology.clients[i])) {
+            // 安装TCP客户端（无限发送，数据带发送时间标签）
+            Ptr<TimestampedBulkSend> tcpClient = CreateObject<TimestampedBulkSend>();
+            tcpClient->Setup(InetSocketAddress(serverAddress, tcpPort), packetSize);
+            topology.clients[i]->AddApplication(tcpClient);
+            tcpClient->SetStartTime(Seconds(2.0));
+            tcpClient->SetStopTime(Seconds(simulationTime - 1));
+            
+            // 安装UDP客户端
+            udpClient.SetAttribute("Remote", AddressValue(InetSocketAddress(serverAddress, udpPort)));
+            ApplicationContainer udpClientApp = udpClient.Install(topology.clients[i]);
+            udpClientApp.Start(Seconds(2.0));
+            udpClientApp.Stop(Seconds(simulationTime - 1));
+            udpClients.push_back(udpClientApp.Get(0));
+            
+            if (!config.flowMonitor) {
+                tcpClient->TraceConnectWithoutContext(
+                    "Tx", MakeBoundCallback(&CountSentPacket, statsTable.GetSlot(tcpSlot)));
+                udpClientApp.Get(0)->TraceConnectWithoutContext(
+                    "Tx", MakeBoundCallback(&CountSentPacket, statsTable.GetSlot(udpSlot)));
+            }
+        }
+    }
+    
+    // 安装FlowMonitor用于更精确的统计
+    FlowMonitorHelper flowMonitor;
+    Ptr<FlowMonitor> monitor;
+    std::unique_ptr<FlowAggregator> aggregator;
+    std::unique_ptr<FlowStatsSampler> sampler;
+    if (config.flowMonitor) {
+        monitor = flowMonitor.InstallAll();
+        aggregator.reset(new FlowAggregator(DynamicCast<Ipv4FlowClassifier>(flowMonitor.GetClassifier())));
+        RegisterFlowGroups(*aggregator, statsTable);
+        // 周期性地流式输出各流的增量统计（时间序列），内存占用不随运行时长增长
+        if (!config.flowSamples.empty()) {
+            sampler.reset(new FlowStatsSampler(monitor,
+                                               DynamicCast<Ipv4FlowClassifier>(flowMonitor.GetClassifier()),
+                                               config.flowSampleFormat, config.flowSamples,
+                                               Seconds(config.flowSampleInterval)));
+            sampler->Start(Seconds(0));
+        }
+    }
+    
+    // hybrid：在发送区间的中点（预热之后）记下快照，外推按后半段的稳态速率进行
+    double snapshotTime = 2.0 + (simulationTime - 3.0) / 2;
+    ScenarioResult snapshot;
+    if (hybrid) {
+        Simulator::Schedule(Seconds(snapshotTime), &SnapshotScenario, monitor, aggregator.get(),
+                            &statsTable, &snapshot);
+    }
+    
+    // 运行仿真并收集统计
+    auto runToEnd = [&]() {
+        SimulationProfiler profiler;
+        profiler.Run();
+        
+        // 收集FlowMonitor统计
+        if (sampler) {
+            sampler->Flush();
+            sampler.reset();
+        }
+        if (monitor) {
+            ApplyFlowMonitorStats(monitor, *aggregator, statsTable);
+        }
+        
+        ScenarioResult result = SnapshotStatsTable(statsTable);
+        ReduceScenarioResult(result);
+        if (hybrid) {
+            ReduceScenarioResult(snapshot);
+            ExtrapolateScenarioResult(result, snapshot, snapshotTime, simulationTime - 1,
+                                      config.simulationTime - 1);
+        }
+        result.profile = profiler.GetProfile();
+        return result;
+    };
+    
+    if (!branches) {
+        Simulator::Stop(Seconds(simulationTime));
+        ScenarioResult result = runToEnd();
+        Simulator::Destroy();
+        return result;
+    }
+    
+    // 预热到检查点；每个变体的子进程都从这一时刻的状态继续
+    Simulator::Stop(Seconds(config.checkpoint));
+    Simulator::Run();
+    branches->results.assign(branches->variants.size(), ScenarioResult());
+    branches->pool->Run(branches->variants.size(),
+                        [&](uint64_t index) {
+                            ApplyCheckpointVariant(branches->variants[index], topology, udpClients);
+                            statsTable.ClearCounters(config.checkpoint);
+                            if (monitor) {
+                                monitor->ResetAllStats();
+                            }
+                            Simulator::Stop(Seconds(simulationTime - config.checkpoint));
+                            return SerializeScenarioResult(runToEnd());
+                        },
+                        [&](uint64_t index, const std::string& payload) {
+                            branches->results[index] = DeserializeScenarioResult(payload);
+                        });
+    Simulator::Destroy();
+    return ScenarioResult();
+}
+
+/**
+ * @brief 运行单个测试场景，返回各协议统计（不输出任何内容）
+ *
+ * branches 的含义见 RunOnTopology。
+ */
+ScenarioResult RunScenario(const ScenarioConfig& config, CheckpointBranches* branches = nullptr) {
+    if (branches && (config.fidelity != "packet" || !config.flowSamples.empty() ||
+                     config.checkpoint <= 2.0 || config.checkpoint >= config.simulationTime - 1)) {
+        NS_FATAL_ERROR("A checkpoint needs a packet-level run without flow samples and a time "
+                       "inside the traffic period (2s, simulationTime-1)");
+    }
+    if (config.fidelity == "fluid") {
+        return RunFluidScenario(config);
+    }
+    Topology topology;
+    BuildScenarioTopology(config, topology);
+    return RunOnTopology(config, topology, branches);
+}
+
+/**
+ * @brief 拓扑结构键：拓扑类型、流数和RNG运行编号相同的任务可共用一次建好的拓扑
+ *
+ * 运行编号也在键中，因为协议栈中的随机变量在建拓扑时就按运行编号初始化。
+ */
+std::string TopologyKey(const ScenarioConfig& config) {
+    return config.topology + "/" + std::to_string(config.flows) + "/" + std::to_string(config.run);
+}
+
+/**
+ * @brief 复用拓扑运行任务 [0, nTasks)：拓扑结构相同的任务为一组，主进程每组只建一次拓扑，
+ * 组内每个任务在从建好的拓扑（尚未开始仿真）分叉出的子进程中改设链路参数、安装应用并运行
+ *
+ * 子进程从 t=0 的状态开始，事件队列和应用状态与重新建拓扑时相同。结果仍按任务编号顺序
+ * 交给 sink（先完成的组的结果在内存中等待）。自动编号的随机数流创建顺序与逐个建拓扑时不同，
+ * 因此结果在统计上等价，但不逐位相同。
+ */
+void RunWithSharedTopology(uint64_t nTasks, const std::function<ScenarioConfig(uint64_t)>& taskConfig,
+                           ForkWorkerPool& pool, const ForkWorkerPool::Sink& sink) {
+    std::vector<std::vector<uint64_t>> groups;
+    std::map<std::string, size_t> groupOfKey;
+    for (uint64_t index = 0; index < nTasks; index++) {
+        auto inserted = groupOfKey.emplace(TopologyKey(taskConfig(index)), groups.size());
+        if (inserted.second) {
+            groups.emplace_back();
+        }
+        groups[inserted.first->second].push_back(index);
+    }
+    
+    std::map<uint64_t, std::string> finished;
+    uint64_t nextEmit = 0;
+    pool.SetIsolated(true);
+    for (const std::vector<uint64_t>& group : groups) {
+        Topology topology;
+        BuildScenarioTopology(taskConfig(group.front()), topology);
+        pool.Run(group.size(),
+                 [&](uint64_t k) {
+                     ScenarioConfig config = taskConfig(group[k]);
+                     if (config.fidelity == "fluid") {
+                         return SerializeScenarioResult(RunFluidScenario(config));
+                     }
+                     ReconfigureTopology(config, topology);
+                     return SerializeScenarioResult(RunOnTopology(config, topology));
+                 },
+                 [&](uint64_t k, const std::string& payload) {
+                     finished[group[k]] = payload;
+                     for (auto next = finished.find(nextEmit); next != finished.end();
+                          next = finished.find(nextEmit)) {
+                         sink(nextEmit++, next->second);
+                         finished.erase(next);
+                     }
+                 });
+        Simulator::Destroy();
+    }
+}
+
+/**
+ * @brief 运行任务 [0, nTasks)，按任务编号把结果交给 sink
+ *
+ * 任务全部为流体模式时在本进程的线程池中运行：流体任务只使用自己的局部状态，
+ * 不必像包级仿真那样每个任务占一个进程（Simulator 等 ns-3 状态是进程内唯一的），
+ * 也就省去了每个工作进程一份的内存。两种方式的并行度都由 --workers 决定。
+ */
+void RunScenarioTasks(uint64_t nTasks, const std::function<ScenarioConfig(uint64_t)>& taskConfig,
+                      ForkWorkerPool& pool, const ForkWorkerPool::Sink& sink) {
+    bool simulatorFree = true;
+    for (uint64_t index = 0; index < nTasks && simulatorFree; index++) {
+        simulatorFree = taskConfig(index).fidelity == "fluid";
+    }
+    if (simulatorFree && pool.GetWorkers() > 1) {
+        WorkStealingPool threads(pool.GetWorkers());
+        threads.Run(nTasks,
+                    [&](uint64_t index) {
+                        return SerializeScenarioResult(RunFluidScenario(taskConfig(index)));
+                    },
+                    sink);
+        return;
+    }
+    pool.Run(nTasks,
+             [&](uint64_t index) {
+                 return SerializeScenarioResult(RunScenario(taskConfig(index)));
+             },
+             sink);
+}
+
+/**
+ * @brief 单个协议的性能指标
+ */
+struct ProtocolMetrics {
+    double throughput;      // Mbps
+    double avgDelay;        // ms
+    double packetLoss;      // %
+};
+
+/**
+ * @brief 指标的统计时长：应用发送区间 [2, simulationTime-1]，使用检查点时从检查点开始
+ */
+double MeasuredTime(const ScenarioConfig& config) {
+    return config.simulationTime - 1.0 - std::max(2.0, config.checkpoint);
+}
+
+/**
+ * @brief 由原始统计计算性能指标，measuredTime 为统计时长（见 MeasuredTime）
+ */
+ProtocolMetrics ComputeMetrics(const ProtocolStats& stats, double measuredTime) {
+    ProtocolMetrics metrics;
+    metrics.throughput = (stats.totalBytesReceived * 8.0) / (measuredTime * 1000000.0);
+    metrics.avgDelay = (stats.delaySamples > 0) ? 
+                       (stats.totalDelay / stats.delaySamples) * 1000 : 0.0;
+    // 使用 FlowMonitor 时，检查点之前发出、之后到达的包只计入接收，接收数可能略超发送数，丢包率截断到0
+    metrics.packetLoss = (stats.totalPacketsSent > 0) ? 
+                         std::max(0.0, 1.0 - (double)stats.totalPacketsReceived / stats.totalPacketsSent) * 100 : 0.0;
+    return metrics;
+}
+
+/**
+ * @brief 计算公平性指数 (Jain's Fairness Index)
+ */
+double ComputeFairnessIndex(const std::vector<double>& throughputs) {
+    double fairnessIndex = 0.0;
+    if (throughputs.size() > 0) {
+        double sum = 0.0, sumSquares = 0.0;
+        for (double t : throughputs) {
+            sum += t;
+            sumSquares += t * t;
+        }
+        if (sumSquares > 0) {
+            fairnessIndex = (sum * sum) / (throughputs.size() * sumSquares);
+        }
+    }
+    return fairnessIndex;
+}
+
+/**
+ * @brief 各流的吞吐量（Mbps），protocol 为空时包含所有协议
+ */
+std::vector<double> FlowThroughputs(const ScenarioResult& result, double measuredTime,
+                                    const std::string& protocol = "") {
+    std::vector<double> throughputs;
+    throughputs.reserve(result.flows.size());
+    for (const FlowResult& flow : result.flows) {
+        if (protocol.empty() || flow.protocol == protocol) {
+            throughputs.push_back(ComputeMetrics(flow.stats, measuredTime).throughput);
+        }
+    }
+    return throughputs;
+}
+
+/**
+ * @brief 场景结果中某协议的时延直方图（没有该协议时返回空直方图）
+ */
+const LatencyHistogram& ProtocolLatency(const ScenarioResult& result, const std::string& protocol) {
+    static const LatencyHistogram empty;
+    auto it = result.latency.find(protocol);
+    return it != result.latency.end() ? it->second : empty;
+}
+
+/**
+ * @brief 直方图分位数，单位ms
+ */
+double LatencyQuantileMs(const LatencyHistogram& histogram, double quantile) {
+    return histogram.GetValueAtQuantile(quantile) / 1e6;
+}
+
+/**
+ * @brief 某协议所有流合计的性能指标
+ *
+ * 平均延迟与时延分位数取自同一个直方图（其总和与样本数），两者度量的是同一种时延：
+ * 应用层单向时延，TCP 包含发送缓冲区中的排队时间，按字节加权。只有直方图为空时
+ * （如数据报放不下时间戳头）才退回到计数块中的时延（使用 FlowMonitor 时为链路层时延）。
+ */
+ProtocolMetrics ComputeProtocolMetrics(const ScenarioResult& result, const std::string& protocol,
+                                       double measuredTime) {
+    ProtocolMetrics metrics = ComputeMetrics(SumProtocolStats(result, protocol), measuredTime);
+    const LatencyHistogram& histogram = ProtocolLatency(result, protocol);
+    if (histogram.GetCount() > 0) {
+        metrics.avgDelay = histogram.GetMean() / 1e6;
+    }
+    return metrics;
+}
+
+/**
+ * @brief 输出单个测试场景的性能统计表
+ */
+void PrintScenarioResult(const ScenarioConfig& config, const ScenarioResult& result) {
+    std::cout << "\n=== 测试场景: " << config.name << " ===" << std::endl;
+    std::cout << "数据率: " << config.dataRate << ", 延迟: " << config.delay;
+    if (config.errorRate > 0) std::cout << ", 错误率: " << config.errorRate;
+    if (config.errorModel != "rate") {
+        std::cout << ", 错误模型: " << config.errorModel;
+        if (!config.burstParams.empty()) std::cout << "(" << config.burstParams << ")";
+    }
+    std::cout << ", TCP算法: " << config.tcpAlgorithm;
+    if (config.run != 1) std::cout << ", 运行编号: " << config.run;
+    if (config.flows > 1 || config.topology != "p2p") {
+        std::cout << ", 拓扑: " << config.topology << ", 流数: " << config.flows;
+    }
+    if (!config.udpDataRate.empty()) std::cout << ", UDP速率: " << config.udpDataRate;
+    if (config.fidelity != "packet") std::cout << ", 仿真精度: " << config.fidelity;
+    std::cout << std::endl;
+    
+    // 计算并输出性能指标
+    std::cout << "\n性能统计结果:" << std::endl;
+    std::cout << "协议\t吞吐量(Mbps)\t平均延迟(ms)\t丢包率(%)\t公平性指数" << std::endl;
+    
+    // 每个协议一行，多流时为该协议所有流的合计
+    for (const char* proto : {"TCP", "UDP"}) {
+        ProtocolMetrics metrics = ComputeProtocolMetrics(result, proto, MeasuredTime(config));
+        
+        std::cout << proto << "\t" 
+                  << std::fixed << std::setprecision(4) << metrics.throughput << "\t\t"
+                  << std::fixed << std::setprecision(2) << metrics.avgDelay << "\t\t"
+                  << std::fixed << std::setprecision(2) << metrics.packetLoss << "\t\t";
+    }
+    
+    // 公平性指数按流计算
+    std::cout << "\n公平性指数: " << std::fixed << std::setprecision(4)
+              << ComputeFairnessIndex(FlowThroughputs(result, MeasuredTime(config))) << std::endl;
+    if (config.flows > 1) {
+        std::cout << "TCP流间公平性指数: " << std::fixed << std::setprecision(4)
+                  << ComputeFairnessIndex(FlowThroughputs(result, MeasuredTime(config), "TCP"))
+                  << ", UDP流间公平性指数: "
+                  << ComputeFairnessIndex(FlowThroughputs(result, MeasuredTime(config), "UDP"))
+                  << std::endl;
+    }
+    
+    // 单向时延分布（由发送时间戳测得）
+    for (const char* proto : {"TCP", "UDP"}) {
+        const LatencyHistogram& histogram = ProtocolLatency(result, proto);
+        std::cout << proto << " 时延分位数(ms): ";
+        if (histogram.GetCount() == 0) {
+            std::cout << "无样本" << std::endl;
+            continue;
+        }
+        std::cout << std::fixed << std::setprecision(3)
+                  << "p50=" << LatencyQuantileMs(histogram, 0.5)
+                  << ", p99=" << LatencyQuantileMs(histogram, 0.99)
+                  << ", p999=" << LatencyQuantileMs(histogram, 0.999)
+                  << (std::string(proto) == "TCP" ? " (样本字节数 " : " (样本数 ")
+                  << histogram.GetCount() << ")" << std::endl;
+    }
+    
+    const SimulationProfile& profile = result.profile;
+    std::cout << std::setprecision(3) << "仿真开销: " << profile.events << " 个事件，墙钟时间 "
+              << profile.wallSeconds << " 秒（每秒 " << profile.GetEventsPerSecond()
+              << " 个事件，仿真/真实时间比 " << profile.GetSimRealRatio() << "），峰值内存 "
+              << profile.peakRssKb << " KiB，创建数据包 " << profile.packetsCreated
+              << " 个，首个事件前 CPU 时间 " << profile.timeToFirstEvent << " 秒" << std::endl;
+}
+
+/**
+ * @brief 交叉验证中的一项指标
+ */
+struct ValidationMetric {
+    std::string name;
+    double packet;          // 包级仿真的结果
+    double approx;          // fluid/hybrid 的结果
+    bool relative;          // true：比较相对误差（%）；false：比较绝对差
+    
+    double GetError() const {
+        if (!relative) {
+            return std::fabs(approx - packet);
+        }
+        return packet != 0 ? std::fabs(approx - packet) / std::fabs(packet) * 100 : 0.0;
+    }
+};
+
+/**
+ * @brief 交叉验证比较的指标：两协议的吞吐量、平均延迟（相对误差）、丢包率和公平性指数（绝对差）
+ */
+std::vector<ValidationMetric> CompareFidelity(const ScenarioConfig& config, const ScenarioResult& packet,
+                                              const ScenarioResult& approx) {
+    std::vector<ValidationMetric> metrics;
+    for (const char* proto : {"TCP", "UDP"}) {
+        ProtocolMetrics p = ComputeProtocolMetrics(packet, proto, MeasuredTime(config));
+        ProtocolMetrics a = ComputeProtocolMetrics(approx, proto, MeasuredTime(config));
+        metrics.push_back({std::string(proto) + "吞吐量(Mbps)", p.throughput, a.throughput, true});
+        metrics.push_back({std::string(proto) + "平均延迟(ms)", p.avgDelay, a.avgDelay, true});
+        metrics.push_back({std::string(proto) + "丢包率(%)", p.packetLoss, a.packetLoss, false});
+    }
+    metrics.push_back({"公平性指数",
+                       ComputeFairnessIndex(FlowThroughputs(packet, MeasuredTime(config))),
+                       ComputeFairnessIndex(FlowThroughputs(approx, MeasuredTime(config))), false});
+    return metrics;
+}
+
+/**
+ * @brief 输出一个场景的交叉验证表，并把各指标误差按顺序累加到 errorSums
+ */
+void PrintCrossValidation(const ScenarioConfig& config, const std::vector<ValidationMetric>& metrics,
+                          std::vector<double>& errorSums) {
+    errorSums.resize(metrics.size(), 0.0);
+    std::cout << "\n交叉验证 (packet vs " << config.fidelity << "):" << std::endl;
+    std::cout << "指标\t\t\tpacket\t\t" << config.fidelity << "\t\t误差" << std::endl;
+    for (size_t i = 0; i < metrics.size(); i++) {
+        const ValidationMetric& metric = metrics[i];
+        std::cout << metric.name << "\t\t" << std::fixed << std::setprecision(4)
+                  << metric.packet << "\t\t" << metric.approx << "\t\t"
+                  << std::setprecision(metric.relative ? 2 : 4) << metric.GetError()
+                  << (metric.relative ? "%" : "") << std::endl;
+        errorSums[i] += metric.GetError();
+    }
+}
+
+/**
+ * @brief 由场景矩阵的第index个点生成场景配置，矩阵中未出现的轴取命令行默认值
+ */
+ScenarioConfig MatrixScenario(const ScenarioMatrix& matrix, uint64_t index,
+                              const ScenarioConfig& defaults) {
+    ScenarioConfig config = defaults;
+    config.name = "matrix#" + std::to_string(index);
+    config.dataRate = matrix.Get(index, "dataRate", defaults.dataRate);
+    config.delay = matrix.Get(index, "delay", defaults.delay);
+    // 浮点默认值直接沿用，不经 std::to_string（只保留6位小数，1e-7 会变成 0）
+    if (matrix.HasAxis("errorRate")) {
+        config.errorRate = std::stod(matrix.Get(index, "errorRate"));
+    }
+    config.tcpAlgorithm = matrix.Get(index, "tcpAlgorithm", defaults.tcpAlgorithm);
+    config.packetSize = std::stoul(matrix.Get(index, "packetSize", std::to_string(defaults.packetSize)));
+    if (matrix.HasAxis("simulationTime")) {
+        config.simulationTime = std::stod(matrix.Get(index, "simulationTime"));
+    }
+    config.run = std::stoull(matrix.Get(index, "seeds", std::to_string(defaults.run)));
+    config.topology = matrix.Get(index, "topology", defaults.topology);
+    config.flows = std::stoul(matrix.Get(index, "flows", std::to_string(defaults.flows)));
+    config.errorModel = matrix.Get(index, "errorModel", defaults.errorModel);
+    config.flowMonitor = defaults.flowMonitor;
+    config.fidelity = matrix.Get(index, "fidelity", defaults.fidelity);
+    config.udpDataRate = matrix.Get(index, "udpDataRate", defaults.udpDataRate);
+    if (!defaults.flowSamples.empty()) {
+        config.flowSamples = defaults.flowSamples + "." + std::to_string(index);
+    }
+    return config;
+}
+
+/**
+ * @brief 矩阵点的预热配置键：除检查点之后可改变的轴（errorRate、udpDataRate）外各轴的取值
+ */
+std::string WarmUpKey(const ScenarioMatrix& matrix, uint64_t index) {
+    std::string key;
+    for (const std::string& axis : matrix.GetAxisNames()) {
+        if (axis != "errorRate" && axis != "udpDataRate") {
+            key += axis + "=" + matrix.Get(index, axis, "") + "\n";
+        }
+    }
+    return key;
+}
+
+// 结果记录的schema版本，字段含义或顺序变化时递增
+const uint32_t SCENARIO_SCHEMA_VERSION = 10;
+
+/**
+ * @brief 生成单次运行的结果记录
+ */
+ResultRecord MakeScenarioRecord(uint64_t index, const ScenarioConfig& config,
+                                const ScenarioResult& result) {
+    ResultRecord record;
+    record.AddUint("index", index)
+          .AddString("scenario", config.name)
+          .AddString("dataRate", config.dataRate)
+          .AddString("delay", config.delay)
+          .AddDouble("errorRate", config.errorRate)
+          .AddString("errorModel", config.errorModel)
+          .AddString("burstParams", config.burstParams)
+          .AddString("tcpAlgorithm", config.tcpAlgorithm)
+          .AddUint("packetSize", config.packetSize)
+          .AddDouble("simulationTime", config.simulationTime)
+          .AddUint("run", config.run)
+          .AddString("topology", config.topology)
+          .AddUint("flows", config.flows)
+          .AddString("statsSource", config.flowMonitor ? "flowmon" : "app")
+          .AddString("fidelity", config.fidelity)
+          .AddString("udpDataRate", config.udpDataRate.empty() ? config.dataRate : config.udpDataRate)
+          .AddDouble("checkpoint", config.checkpoint);
+    
+    for (const char* proto : {"TCP", "UDP"}) {
+        ProtocolStats stats = SumProtocolStats(result, proto);
+        ProtocolMetrics metrics = ComputeProtocolMetrics(result, proto, MeasuredTime(config));
+        std::string prefix = std::string(proto) == "TCP" ? "tcp" : "udp";
+        record.AddUint(prefix + "PacketsSent", stats.totalPacketsSent)
+              .AddUint(prefix + "PacketsReceived", stats.totalPacketsReceived)
+              .AddUint(prefix + "BytesReceived", stats.totalBytesReceived)
+              .AddDouble(prefix + "Throughput", metrics.throughput)
+              .AddDouble(prefix + "AvgDelay", metrics.avgDelay)
+              .AddDouble(prefix + "PacketLoss", metrics.packetLoss)
+              .AddDouble(prefix + "FairnessIndex",
+                         ComputeFairnessIndex(FlowThroughputs(result, MeasuredTime(config), proto)));
+        
+        // 时延分位数与 AvgDelay 同源（见 ComputeProtocolMetrics）；TCP 的样本数按字节计
+        const LatencyHistogram& histogram = ProtocolLatency(result, proto);
+        record.AddUint(prefix + "LatencySamples", histogram.GetCount())
+              .AddDouble(prefix + "LatencyP50", LatencyQuantileMs(histogram, 0.5))
+              .AddDouble(prefix + "LatencyP99", LatencyQuantileMs(histogram, 0.99))
+              .AddDouble(prefix + "LatencyP999", LatencyQuantileMs(histogram, 0.999));
+    }
+    record.AddDouble("fairnessIndex", ComputeFairnessIndex(FlowThroughputs(result, MeasuredTime(config))));
+    result.profile.AddToRecord(record);
+    return record;
+}
+
+/**
+ * @brief 结束分布式运行（未启用MPI时不做任何事）
+ */
+void FinishPartition() {
+#ifdef NS3_MPI
+    if (MpiInterface::IsEnabled()) {
+        MpiInterface::Disable();
+    }
+#endif
+}
+
+/**
+ * @brief 主函数
+ */
+int main(int argc, char *argv[]) {
+    // 默认参数
+    std::string dataRate = "10Mbps";
+    std::string delay = "2ms";
+    double errorRate = 0.0;
+    std::string errorModel = "rate";
+    std::string burstParams;
+    bool perDeviceErrorModel = true;
+    std::string tcpAlgorithm = "NewReno";
+    uint32_t packetSize = 1024;
+    double simulationTime = 20.0;
+    uint32_t workers = 1;
+    uint32_t runs = 1;
+    std::string scenariosFile;
+    std::string resultFormat = "text";
+    std::string resultFile;
+    std::string topology = "p2p";
+    uint32_t flows = 1;
+    bool flowMonitor = true;
+    std::string flowSamples;
+    std::string flowSampleFormat = "bin";
+    double flowSampleInterval = 0.1;
+    bool mpi = false;
+    bool nullmsg = false;
+    std::string fidelity = "packet";
+    double hybridTime = 10.0;
+    bool crossValidate = false;
+    std::string udpDataRate;
+    double checkpoint = 0.0;
+    bool reuseTopology = false;
+    std::string scheduler = "map";
+    
+    // 命令行参数解析
+    CommandLine cmd;
+    cmd.AddValue("dataRate", "PointToPoint link data rate", dataRate);
+    cmd.AddValue("delay", "PointToPoint link delay", delay);
+    cmd.AddValue("errorRate", "Packet error rate", errorRate);
+    cmd.AddValue("errorModel", "Error model (rate: independent, burst: BurstErrorModel, gilbert: Gilbert-Elliott)", errorModel);
+    cmd.AddValue("burstParams", "Error model parameters, e.g. minBurst=1,maxBurst=4 or pBadGood=0.25,lossBad=1", burstParams);
+    cmd.AddValue("perDeviceErrorModel", "p2p: give each end of the link its own error model (false: both directions share one)", perDeviceErrorModel);
+    cmd.AddValue("udpDataRate", "Total UDP sending rate, split over the flows (default: the link data rate)", udpDataRate);
+    cmd.AddValue("tcpAlgorithm", "TCP congestion control algorithm (NewReno, Cubic, Vegas)", tcpAlgorithm);
+    cmd.AddValue("packetSize", "Packet size in bytes", packetSize);
+    cmd.AddValue("simulationTime", "Simulation time in seconds", simulationTime);
+    cmd.AddValue("topology", "Network topology (p2p: one link; dumbbell: shared bottleneck)", topology);
+    cmd.AddValue("flows", "Number of client/server pairs, each with one TCP and one UDP flow", flows);
+    cmd.AddValue("flowMonitor", "Use FlowMonitor for per-flow statistics (false: application counters only)", flowMonitor);
+    cmd.AddValue("flowSamples", "Stream per-flow FlowMonitor deltas to <file>.<run index> (one file per run)", flowSamples);
+    cmd.AddValue("flowSampleFormat", "Flow sample format (csv, jsonl, bin)", flowSampleFormat);
+    cmd.AddValue("flowSampleInterval", "Flow sample interval in seconds", flowSampleInterval);
+    cmd.AddValue("mpi", "Run the dumbbell distributed over MPI ranks (needs an MPI-enabled build; implies flowMonitor=false)", mpi);
+    cmd.AddValue("nullmsg", "With --mpi, use the null-message scheduler instead of granted-time-window", nullmsg);
+    cmd.AddValue("fidelity", "Simulation fidelity (packet: packet-level; fluid: flow-level model, not yet validated, see crossValidate; hybrid: packet-level for hybridTime, then extrapolate)", fidelity);
+    cmd.AddValue("hybridTime", "With --fidelity=hybrid, seconds simulated at packet level", hybridTime);
+    cmd.AddValue("crossValidate", "Run each built-in scenario at packet level too and report the error of --fidelity", crossValidate);
+    cmd.AddValue("checkpoint", "With --scenarios, warm up once to this time and fork the errorRate/udpDataRate variants from there (0 = off)", checkpoint);
+    cmd.AddValue("reuseTopology", "Build each topology (type, flows, RNG run) once and fork every scenario on it from there", reuseTopology);
+    cmd.AddValue("scheduler", "Event scheduler (map, list, heap, calendar, priority)", scheduler);
+    cmd.AddValue("workers", "Number of parallel workers (0 = one per CPU, 1 = serial); threads in one process when every scenario is --fidelity=fluid, else processes", workers);
+    cmd.AddValue("runs", "Number of RNG runs per scenario, starting at RngRun", runs);
+    cmd.AddValue("scenarios", "Scenario matrix file; runs its cartesian product instead of the built-in scenarios", scenariosFile);
+    cmd.AddValue("resultFormat", "Result output format (text, csv, jsonl, bin)", resultFormat);
+    cmd.AddValue("resultFile", "Result output file for csv/jsonl/bin (default: stdout)", resultFile);
+    cmd.Parse(argc, argv);
+    
+    if (runs == 0) {
+        NS_FATAL_ERROR("runs must be at least 1");
+    }
+    if (!flowSamples.empty() && !flowMonitor) {
+        NS_FATAL_ERROR("--flowSamples needs --flowMonitor=true");
+    }
+    if (fidelity != "packet" && fidelity != "fluid" && fidelity != "hybrid") {
+        NS_FATAL_ERROR("Unknown fidelity: " << fidelity << " (expected packet, fluid or hybrid)");
+    }
+    if (hybridTime <= 3.0) {
+        NS_FATAL_ERROR("hybridTime must be greater than 3 seconds (traffic runs from 2s to hybridTime-1)");
+    }
+    if (!flowSamples.empty() && fidelity == "fluid") {
+        NS_FATAL_ERROR("--flowSamples needs a packet-level run, not --fidelity=fluid");
+    }
+    if (crossValidate && fidelity == "packet") {
+        NS_FATAL_ERROR("--crossValidate compares --fidelity=fluid or hybrid against packet level");
+    }
+    if (crossValidate && !scenariosFile.empty()) {
+        NS_FATAL_ERROR("--crossValidate runs the built-in scenarios and cannot be used with --scenarios");
+    }
+    if (checkpoint > 0 && (scenariosFile.empty() || mpi || fidelity != "packet" || !flowSamples.empty())) {
+        NS_FATAL_ERROR("--checkpoint needs --scenarios, packet fidelity, no --mpi and no --flowSamples");
+    }
+    if (reuseTopology && (mpi || checkpoint > 0)) {
+        NS_FATAL_ERROR("--reuseTopology cannot be combined with --mpi or --checkpoint");
+    }
+    // 在分叉工作进程之前检查错误模型名称和参数；调度器选择由工作进程继承
+    ErrorModelFactory::Validate(errorModel, errorRate, burstParams);
+    SetSchedulerType(scheduler);
+    
+    // 分布式模式：所有进程按相同顺序运行同一组场景，每个进程只仿真自己分区内的节点，
+    // 结果归约到0号进程输出
+    if (mpi) {
+#ifdef NS3_MPI
+        GlobalValue::Bind("SimulatorImplementationType",
+                          StringValue(nullmsg ? "ns3::NullMessageSimulatorImpl"
+                                              : "ns3::DistributedSimulatorImpl"));
+        MpiInterface::Enable(&argc, &argv);
+        partition.systemId = MpiInterface::GetSystemId();
+        partition.systemCount = MpiInterface::GetSize();
+        // 各进程共同推进同一次仿真，不能再分叉工作进程
+        workers = 1;
+        // FlowMonitor 只能跟踪在同一进程内收发的数据包
+        flowMonitor = false;
+        if (!flowSamples.empty()) {
+            NS_FATAL_ERROR("--flowSamples needs FlowMonitor, which is not available with --mpi");
+        }
+#else
+        NS_FATAL_ERROR("--mpi requires ns-3 configured with --enable-mpi");
+#endif
+    }
+    bool rootRank = partition.systemId == 0;
+    
+    uint64_t baseRun = RngSeedManager::GetRun();
+    ForkWorkerPool pool(workers);
+    
+    // 矩阵模式：按需展开矩阵点，每完成一次运行输出一行
+    if (!scenariosFile.empty()) {
+        ScenarioMatrix matrix;
+        matrix.Load(scenariosFile);
+        for (const std::string& axis : matrix.GetAxisNames()) {
+            if (axis != "dataRate" && axis != "delay" && axis != "errorRate" &&
+                axis != "tcpAlgorithm" && axis != "packetSize" && axis != "simulationTime" &&
+                axis != "seeds" && axis != "topology" && axis != "flows" && axis != "errorModel" &&
+                axis != "fidelity" && axis != "udpDataRate") {
+                NS_FATAL_ERROR("Unknown scenario matrix axis: " << axis);
+            }
+        }
+        if (checkpoint > 0 && matrix.HasAxis("fidelity")) {
+            NS_FATAL_ERROR("--checkpoint needs packet fidelity; remove the fidelity axis");
+        }
+        if (!matrix.HasAxis("seeds")) {
+            matrix.AddAxis("seeds", std::to_string(baseRun) + ".." + std::to_string(baseRun + runs - 1));
+        }
+        
+        // 矩阵模式总是输出结构化记录，默认CSV
+        // 非0号进程不输出
+        ResultWriter writer(!rootRank ? "text" : resultFormat == "text" ? "csv" : resultFormat,
+                            "lab3-tcp-udp-comparison", SCENARIO_SCHEMA_VERSION, resultFile);
+        ScenarioConfig defaults = {"", dataRate, delay, errorRate, tcpAlgorithm,
+                                   packetSize, simulationTime, baseRun, topology, flows, flowMonitor,
+                                   errorModel, burstParams, perDeviceErrorModel,
+                                   flowSamples, flowSampleFormat, flowSampleInterval,
+                                   fidelity, hybridTime, udpDataRate, checkpoint};
+        
+        // 检查点模式：预热配置相同的矩阵点为一组，主进程逐组预热到检查点，
+        // 组内各点在工作进程中从检查点分叉运行；记录按组输出（index 字段为矩阵点编号）
+        if (checkpoint > 0) {
+            std::vector<std::vector<uint64_t>> groups;
+            std::map<std::string, size_t> groupOfKey;
+            for (uint64_t index = 0; index < matrix.GetSize(); index++) {
+                auto inserted = groupOfKey.emplace(WarmUpKey(matrix, index), groups.size());
+                if (inserted.second) {
+                    groups.emplace_back();
+                }
+                groups[inserted.first->second].push_back(index);
+            }
+            pool.SetIsolated(true);
+            for (const std::vector<uint64_t>& group : groups) {
+                CheckpointBranches branches;
+                branches.pool = &pool;
+                for (uint64_t index : group) {
+                    branches.variants.push_back(MatrixScenario(matrix, index, defaults));
+                }
+                // 预热阶段使用命令行的错误率和UDP速率
+                ScenarioConfig warmUp = branches.variants.front();
+                warmUp.errorRate = errorRate;
+                warmUp.udpDataRate = udpDataRate;
+                RunScenario(warmUp, &branches);
+                for (size_t k = 0; k < group.size(); k++) {
+                    writer.Write(MakeScenarioRecord(group[k], branches.variants[k], branches.results[k]));
+                }
+                writer.Flush();
+            }
+            FinishPartition();
+            return 0;
+        }
+        
+        auto writeRecord = [&](uint64_t index, const std::string& payload) {
+            writer.Write(MakeScenarioRecord(index, MatrixScenario(matrix, index, defaults),
+                                            DeserializeScenarioResult(payload)));
+            writer.Flush();
+        };
+        auto matrixConfig = [&](uint64_t index) { return MatrixScenario(matrix, index, defaults); };
+        if (reuseTopology) {
+            RunWithSharedTopology(matrix.GetSize(), matrixConfig, pool, writeRecord);
+        } else {
+            RunScenarioTasks(matrix.GetSize(), matrixConfig, pool, writeRecord);
+        }
+        FinishPartition();
+        return 0;
+    }
+    
+    // 选择结构化输出时，标准输出只包含结果记录；非0号进程不输出
+    ResultWriter writer(rootRank ? resultFormat : "text", "lab3-tcp-udp-comparison",
+                        SCENARIO_SCHEMA_VERSION, resultFile);
+    bool textOutput = rootRank && !writer.IsEnabled();
+    
+    if (textOutput) {
+        std::cout << "=== TCP vs UDP 协议性能对比研究 ===" << std::endl;
+        std::cout << "默认参数: 数据率=" << dataRate << ", 延迟=" << delay;
+        if (errorRate > 0) std::cout << ", 错误率=" << errorRate;
+        std::cout << ", TCP算法=" << tcpAlgorithm << ", 包大小=" << packetSize << "B";
+        if (flows > 1 || topology != "p2p") {
+            std::cout << ", 拓扑=" << topology << ", 流数=" << flows;
+        }
+        std::cout << std::endl;
+    }
+    
+    // 测试场景表（输出顺序固定为此顺序）
+    std::vector<ScenarioConfig> scenarios = {
+        // 测试场景1: 理想网络条件
+        {"理想网络条件", "10Mbps", "2ms", 0.0, "NewReno", packetSize, simulationTime, 0},
+        // 测试场景2: 高延迟网络
+        {"高延迟网络", "10Mbps", "50ms", 0.0, "NewReno", packetSize, simulationTime, 0},
+        // 测试场景3: 有丢包网络
+        {"有丢包网络", "10Mbps", "2ms", 0.01, "NewReno", packetSize, simulationTime, 0},
+        // 测试场景4: 低带宽网络
+        {"低带宽网络", "1Mbps", "2ms", 0.0, "NewReno", packetSize, simulationTime, 0},
+        // 测试场景5: 不同TCP拥塞控制算法
+        {"TCP Cubic算法", "10Mbps", "2ms", 0.0, "Cubic", packetSize, simulationTime, 0},
+        {"TCP Vegas算法", "10Mbps", "2ms", 0.0, "Vegas", packetSize, simulationTime, 0},
+        // 测试场景6: 混合网络条件
+        {"混合网络条件", "5Mbps", "20ms", 0.005, "NewReno", packetSize, simulationTime, 0},
+    };
+    for (ScenarioConfig& scenario : scenarios) {
+        scenario.topology = topology;
+        scenario.flows = flows;
+        scenario.flowMonitor = flowMonitor;
+        scenario.errorModel = errorModel;
+        scenario.burstParams = burstParams;
+        scenario.perDeviceErrorModel = perDeviceErrorModel;
+        scenario.flowSampleFormat = flowSampleFormat;
+        scenario.flowSampleInterval = flowSampleInterval;
+        scenario.fidelity = fidelity;
+        scenario.hybridTime = hybridTime;
+        scenario.udpDataRate = udpDataRate;
+    }
+    
+    // 每个场景按RNG运行编号展开为 runs 个独立任务，任务i对应场景 i/runs 的第 i%runs 次运行
+    // 交叉验证时每个任务再拆成相邻的两个：先包级仿真，后 --fidelity 指定的模式
+    uint64_t tasksPerRun = crossValidate ? 2 : 1;
+    auto taskConfig = [&](uint64_t index) {
+        uint64_t run = index / tasksPerRun;
+        ScenarioConfig config = scenarios[run / runs];
+        config.run = baseRun + run % runs;
+        if (crossValidate && index % 2 == 0) {
+            config.fidelity = "packet";
+        }
+        if (!flowSamples.empty()) {
+            config.flowSamples = flowSamples + "." + std::to_string(index);
+        }
+        return config;
+    };
+    
+    if (textOutput && pool.GetWorkers() > 1) {
+        // 全部为流体模式时在线程池中运行（见 RunScenarioTasks）
+        bool threaded = fidelity == "fluid" && !crossValidate && !reuseTopology;
+        std::cout << (threaded ? "并行工作线程数: " : "并行工作进程数: ") << pool.GetWorkers() << std::endl;
+    }
+    // 结果按任务顺序送达，交叉验证时包级结果总是先于对应的近似结果
+    ScenarioResult packetResult;
+    std::vector<ValidationMetric> lastMetrics;
+    std::vector<double> errorSums;
+    auto handleResult = [&](uint64_t index, const std::string& payload) {
+        ScenarioResult result = DeserializeScenarioResult(payload);
+        ScenarioConfig config = taskConfig(index);
+        if (textOutput) {
+            PrintScenarioResult(config, result);
+        } else {
+            writer.Write(MakeScenarioRecord(index, config, result));
+        }
+        if (!crossValidate) {
+            return;
+        }
+        if (index % 2 == 0) {
+            packetResult = std::move(result);
+        } else if (textOutput) {
+            lastMetrics = CompareFidelity(config, packetResult, result);
+            PrintCrossValidation(config, lastMetrics, errorSums);
+        }
+    };
+    uint64_t nTasks = scenarios.size() * runs * tasksPerRun;
+    if (reuseTopology) {
+        RunWithSharedTopology(nTasks, taskConfig, pool, handleResult);
+    } else {
+        RunScenarioTasks(nTasks, taskConfig, pool, handleResult);
+    }
+    
+    if (textOutput && crossValidate) {
+        uint64_t compared = scenarios.size() * runs;
+        std::cout << "\n=== 交叉验证汇总 (packet vs " << fidelity << ", " << compared
+                  << " 次运行的平均误差) ===" << std::endl;
+        for (size_t i = 0; i < lastMetrics.size(); i++) {
+            bool relative = lastMetrics[i].relative;
+            std::cout << lastMetrics[i].name << ": " << std::fixed << std::setprecision(relative ? 2 : 4)
+                      << errorSums[i] / compared << (relative ? "%" : "") << std::endl;
+        }
+    }
+    
+    if (textOutput) {
+        std::cout << "\n=== 所有测试场景完成 ===" << std::endl;
+        std::cout << "测试总结:" << std::endl;
+        std::cout << "1. TCP在拥塞网络中表现更好，能够自适应调整发送速率" << std::endl;
+        std::cout << "2. UDP在低延迟要求下表现更好，但缺乏拥塞控制" << std::endl;
+        std::cout << "3. 不同TCP算法在不同网络条件下表现各异" << std::endl;
+        std::cout << "4. 公平性指数反映了协议间的资源分配公平性" << std::endl;
+    }
     
+    FinishPartition();
     return 0;
 }